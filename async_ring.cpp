@@ -0,0 +1,181 @@
+#include "async_ring.h"
+#include "optimized_status.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+static_assert(RING_VALUE_LEN == MAX_VALUE_LEN, "ring values must hold any table value");
+
+const char *const SQ_SUFFIX = ".sq";
+const char *const CQ_SUFFIX = ".cq";
+
+// 入队长度：定长头部加上实际的值
+inline size_t submissionLength(const RingSubmission &submission) {
+    return offsetof(RingSubmission, value) + submission.value_len;
+}
+
+inline size_t completionLength(const RingCompletion &completion) {
+    return offsetof(RingCompletion, value) + completion.value_len;
+}
+
+} // namespace
+
+AsyncRing::AsyncRing(const std::string &name, int entries) : name_(name), sq_(nullptr), cq_(nullptr) {
+    if (name.empty() || name.length() > static_cast<size_t>(RING_NAME_LEN)) {
+        throw std::runtime_error("invalid ring name: " + name);
+    }
+    SharedArena arena = OptimizedStatusRscManager::sharedArena();
+    // 应用线程写回完成项时CQ满会停止取出提交，CQ取两倍容量给收割留出余量
+    sq_ = ShmQueue::create(arena, name + SQ_SUFFIX, QUEUE_SPSC, entries, sizeof(RingSubmission));
+    cq_ = ShmQueue::create(arena, name + CQ_SUFFIX, QUEUE_SPSC, entries * 2, sizeof(RingCompletion));
+    if (sq_ == nullptr || cq_ == nullptr) {
+        throw std::runtime_error("cannot create ring " + name);
+    }
+}
+
+std::string AsyncRing::defaultName() {
+    return "ring." + std::to_string(getpid());
+}
+
+int AsyncRing::destroy(const std::string &name) {
+    SharedArena arena = OptimizedStatusRscManager::sharedArena();
+    int sq_result = ShmQueue::destroy(arena, name + SQ_SUFFIX);
+    int cq_result = ShmQueue::destroy(arena, name + CQ_SUFFIX);
+    return sq_result == OK && cq_result == OK ? OK : NOT_FOUND;
+}
+
+int AsyncRing::submit(const RingSubmission &submission, int timeout_ms) {
+    if (submission.value_len > static_cast<uint32_t>(RING_VALUE_LEN)) {
+        return -1;
+    }
+    return ShmQueue(sq_).enqueue(&submission, submissionLength(submission), timeout_ms);
+}
+
+int AsyncRing::submitBatch(const std::vector<RingSubmission> &submissions, int timeout_ms) {
+    std::vector<const void *> data(submissions.size());
+    std::vector<size_t> lengths(submissions.size());
+    for (size_t i = 0; i < submissions.size(); ++i) {
+        if (submissions[i].value_len > static_cast<uint32_t>(RING_VALUE_LEN)) {
+            return -1;
+        }
+        data[i] = &submissions[i];
+        lengths[i] = submissionLength(submissions[i]);
+    }
+    return ShmQueue(sq_).enqueueBatch(data.data(), lengths.data(), static_cast<int>(submissions.size()),
+                                      timeout_ms);
+}
+
+int AsyncRing::submitUpsert(int key, const std::string &value, uint64_t user_data, int timeout_ms) {
+    if (value.length() > static_cast<size_t>(RING_VALUE_LEN)) {
+        return -1;
+    }
+    RingSubmission submission;
+    submission.user_data = user_data;
+    submission.opcode = RING_OP_UPSERT;
+    submission.key = key;
+    submission.value_len = static_cast<uint32_t>(value.length());
+    memcpy(submission.value, value.data(), value.length());
+    return submit(submission, timeout_ms);
+}
+
+int AsyncRing::submitGet(int key, uint64_t user_data, int timeout_ms) {
+    RingSubmission submission;
+    submission.user_data = user_data;
+    submission.opcode = RING_OP_GET;
+    submission.key = key;
+    submission.value_len = 0;
+    return submit(submission, timeout_ms);
+}
+
+int AsyncRing::reap(std::vector<RingCompletion> &completions, int max_count, int timeout_ms) {
+    completions.resize(max_count > 0 ? max_count : 0);
+    std::vector<size_t> lengths(completions.size());
+    int count = ShmQueue(cq_).dequeueBatch(completions.data(), sizeof(RingCompletion), lengths.data(),
+                                           max_count, timeout_ms);
+    completions.resize(count > 0 ? count : 0);
+    return count;
+}
+
+RingApplier::RingApplier(OptimizedStatusRscManager *manager, const std::string &name, int max_batch)
+    : manager_(manager), sq_(nullptr), cq_(nullptr), max_batch_(max_batch > 0 ? max_batch : RING_DEFAULT_BATCH),
+      stopping_(false), applied_(0), batches_(0) {
+    SharedArena arena = OptimizedStatusRscManager::sharedArena();
+    sq_ = ShmQueue::open(arena, name + SQ_SUFFIX);
+    cq_ = ShmQueue::open(arena, name + CQ_SUFFIX);
+    if (sq_ == nullptr || cq_ == nullptr) {
+        throw std::runtime_error("ring not found: " + name);
+    }
+    submissions_.resize(max_batch_);
+    lengths_.resize(max_batch_);
+    completions_.resize(max_batch_);
+}
+
+RingApplier::~RingApplier() {
+    stop();
+}
+
+int RingApplier::start() {
+    if (thread_.joinable()) {
+        return -1;
+    }
+    stopping_.store(false);
+    try {
+        thread_ = std::thread(&RingApplier::run, this);
+    } catch (const std::system_error &) {
+        return -1;
+    }
+    return OK;
+}
+
+void RingApplier::stop() {
+    stopping_.store(true);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void RingApplier::run() {
+    while (!stopping_.load(std::memory_order_relaxed)) {
+        poll(RING_APPLIER_POLL_MS);
+    }
+}
+
+int RingApplier::poll(int timeout_ms) {
+    int count = ShmQueue(sq_).dequeueBatch(submissions_.data(), sizeof(RingSubmission), lengths_.data(),
+                                           max_batch_, timeout_ms);
+    if (count <= 0) {
+        return 0;
+    }
+    // 长度与value_len不符的提交项标记为无效，applySubmissions对其返回-1
+    for (int i = 0; i < count; ++i) {
+        if (lengths_[i] < offsetof(RingSubmission, value) || lengths_[i] != submissionLength(submissions_[i])) {
+            submissions_[i].value_len = RING_VALUE_LEN + 1;
+        }
+    }
+    manager_->applySubmissions(submissions_.data(), count, completions_.data());
+
+    // CQ满时等待客户端收割；停止时丢弃未写回的完成项
+    const void *data[RING_DEFAULT_BATCH];
+    size_t lengths[RING_DEFAULT_BATCH];
+    int written = 0;
+    while (written < count) {
+        int chunk = std::min(count - written, RING_DEFAULT_BATCH);
+        for (int i = 0; i < chunk; ++i) {
+            data[i] = &completions_[written + i];
+            lengths[i] = completionLength(completions_[written + i]);
+        }
+        int ret = ShmQueue(cq_).enqueueBatch(data, lengths, chunk, RING_APPLIER_POLL_MS);
+        if (ret > 0) {
+            written += ret;
+        } else if (stopping_.load(std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    applied_.fetch_add(count, std::memory_order_relaxed);
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    return count;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "shm_queue.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+class OptimizedStatusRscManager;
+
+// 异步环：仿照io_uring，每个客户端一对提交环(SQ)与完成环(CQ)，放在段内通用内存区。
+// 客户端线程只写SQ、读CQ，从不获取table_mutex；应用线程（可在客户端进程内，
+// 也可在独立的守护进程中）成批取出提交，在一次持锁内按顺序执行后写回完成；
+// 设置了max_batch_per_lock时按该值分段让出锁
+const int RING_VALUE_LEN = 256;         // 与MAX_VALUE_LEN相同
+const int RING_DEFAULT_ENTRIES = 256;   // SQ容量；CQ为其两倍
+const int RING_DEFAULT_BATCH = 64;      // 应用线程单次持锁处理的最大提交数
+const int RING_NAME_LEN = 27;           // 受arena具名根的名称长度限制
+const int RING_APPLIER_POLL_MS = 50;    // 应用线程空闲时检查停止标志的间隔
+
+enum RingOpcode {
+  RING_OP_NOP = 0,
+  RING_OP_ADD,
+  RING_OP_GET,
+  RING_OP_UPDATE,
+  RING_OP_UPSERT,
+  RING_OP_REMOVE,
+  RING_OP_CONTAINS,
+};
+
+// 提交项；入队时只复制value的前value_len字节
+struct RingSubmission {
+  uint64_t user_data; // 原样带回完成项
+  uint32_t opcode;
+  int key;
+  uint32_t value_len;
+  char value[RING_VALUE_LEN];
+};
+
+// 完成项：result为对应同步接口的返回值（CONTAINS为0/1，GET为OK或NOT_FOUND），
+// 提交项无效时为-1；GET的值在value中，入队时同样只复制value_len字节
+struct RingCompletion {
+  uint64_t user_data;
+  int result;
+  uint32_t value_len;
+  char value[RING_VALUE_LEN];
+};
+
+// 客户端：创建或打开名为name的环对。提交与收割各自只能由一个线程调用
+class AsyncRing {
+public:
+  // 空间不足、名称过长或同名环参数不同时抛出std::runtime_error
+  explicit AsyncRing(const std::string &name = defaultName(),
+                     int entries = RING_DEFAULT_ENTRIES);
+
+  // 本进程的默认环名
+  static std::string defaultName();
+  // 释放环对占用的内存，调用时应用线程须已停止
+  static int destroy(const std::string &name);
+
+  // SQ满时按timeout_ms等待（0不等待，小于0一直等待），超时返回NO_SPACE_ERR，
+  // 值过长返回-1。客户端须持续收割，否则CQ写满后应用线程停止取出新的提交
+  int submit(const RingSubmission &submission, int timeout_ms = -1);
+  // 返回入队条数，有提交项无效时返回-1且不入队任何提交
+  int submitBatch(const std::vector<RingSubmission> &submissions,
+                  int timeout_ms = -1);
+  int submitUpsert(int key, const std::string &value, uint64_t user_data,
+                   int timeout_ms = -1);
+  int submitGet(int key, uint64_t user_data, int timeout_ms = -1);
+
+  // 最多收割max_count条完成项；timeout_ms为0时轮询，否则在futex上等到至少一条或超时
+  int reap(std::vector<RingCompletion> &completions, int max_count,
+           int timeout_ms = 0);
+
+  const std::string &name() const { return name_; }
+  int submitted() const { return ShmQueue(sq_).size(); }
+  int completed() const { return ShmQueue(cq_).size(); }
+
+private:
+  std::string name_;
+  ShmQueueHeader *sq_;
+  ShmQueueHeader *cq_;
+};
+
+// 应用线程：服务一个环对，所有提交都作用于构造时指定的键空间
+class RingApplier {
+public:
+  // 环不存在时抛出std::runtime_error
+  RingApplier(OptimizedStatusRscManager *manager, const std::string &name,
+              int max_batch = RING_DEFAULT_BATCH);
+  ~RingApplier();
+
+  RingApplier(const RingApplier &) = delete;
+  RingApplier &operator=(const RingApplier &) = delete;
+
+  // 启动后台线程；也可由守护进程的主循环直接调用poll()
+  int start();
+  // 停止并等待后台线程退出，最多延迟RING_APPLIER_POLL_MS
+  void stop();
+
+  // 取出一批提交（SQ空时最多等待timeout_ms）并执行，写回全部完成项后返回执行条数
+  int poll(int timeout_ms);
+
+  uint64_t appliedCount() const {
+    return applied_.load(std::memory_order_relaxed);
+  }
+  uint64_t batchCount() const {
+    return batches_.load(std::memory_order_relaxed);
+  }
+
+private:
+  void run();
+
+private:
+  OptimizedStatusRscManager *manager_;
+  ShmQueueHeader *sq_;
+  ShmQueueHeader *cq_;
+  int max_batch_;
+  std::vector<RingSubmission> submissions_;
+  std::vector<size_t> lengths_;
+  std::vector<RingCompletion> completions_;
+  std::atomic<bool> stopping_;
+  std::thread thread_;
+  std::atomic<uint64_t> applied_;
+  std::atomic<uint64_t> batches_;
+};
@@ -0,0 +1,174 @@
+#include "batch_hash.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SHM_BATCH_HASH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+typedef void (*BatchHashFn)(const int *, int, uint32_t, uint32_t, uint32_t *,
+                            uint32_t *);
+
+void hashScalar(const int *keys, int count, uint32_t seed, uint32_t mask,
+                uint32_t *hash1, uint32_t *hash2) {
+    for (int i = 0; i < count; ++i) {
+        hash1[i] = murmurMix1(keys[i], seed) & mask;
+        hash2[i] = (murmurMix2(keys[i], seed) & mask) | 1;
+    }
+}
+
+#ifdef SHM_BATCH_HASH_X86
+
+// 各实现只在函数级开启对应指令集，库本身仍按基线编译，
+// 不支持的CPU上不会执行到这些函数
+
+__attribute__((target("sse4.1")))
+void hashSse41(const int *keys, int count, uint32_t seed, uint32_t mask,
+               uint32_t *hash1, uint32_t *hash2) {
+    const __m128i seed1 = _mm_set1_epi32(static_cast<int>(seed));
+    const __m128i seed2 = _mm_set1_epi32(static_cast<int>(seed + 0x9e3779b9));
+    const __m128i vmask = _mm_set1_epi32(static_cast<int>(mask));
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i c1 = _mm_set1_epi32(static_cast<int>(0x85ebca6b));
+    const __m128i c2 = _mm_set1_epi32(static_cast<int>(0xc2b2ae35));
+    const __m128i d1 = _mm_set1_epi32(static_cast<int>(0x21f0aaad));
+    const __m128i d2 = _mm_set1_epi32(static_cast<int>(0x735a2d97));
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+
+        __m128i a = _mm_xor_si128(k, seed1);
+        a = _mm_xor_si128(a, _mm_srli_epi32(a, 16));
+        a = _mm_mullo_epi32(a, c1);
+        a = _mm_xor_si128(a, _mm_srli_epi32(a, 13));
+        a = _mm_mullo_epi32(a, c2);
+        a = _mm_xor_si128(a, _mm_srli_epi32(a, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(hash1 + i), _mm_and_si128(a, vmask));
+
+        __m128i b = _mm_xor_si128(k, seed2);
+        b = _mm_xor_si128(b, _mm_srli_epi32(b, 16));
+        b = _mm_mullo_epi32(b, d1);
+        b = _mm_xor_si128(b, _mm_srli_epi32(b, 15));
+        b = _mm_mullo_epi32(b, d2);
+        b = _mm_xor_si128(b, _mm_srli_epi32(b, 15));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(hash2 + i),
+                         _mm_or_si128(_mm_and_si128(b, vmask), one));
+    }
+    hashScalar(keys + i, count - i, seed, mask, hash1 + i, hash2 + i);
+}
+
+__attribute__((target("avx2")))
+void hashAvx2(const int *keys, int count, uint32_t seed, uint32_t mask,
+              uint32_t *hash1, uint32_t *hash2) {
+    const __m256i seed1 = _mm256_set1_epi32(static_cast<int>(seed));
+    const __m256i seed2 = _mm256_set1_epi32(static_cast<int>(seed + 0x9e3779b9));
+    const __m256i vmask = _mm256_set1_epi32(static_cast<int>(mask));
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i c1 = _mm256_set1_epi32(static_cast<int>(0x85ebca6b));
+    const __m256i c2 = _mm256_set1_epi32(static_cast<int>(0xc2b2ae35));
+    const __m256i d1 = _mm256_set1_epi32(static_cast<int>(0x21f0aaad));
+    const __m256i d2 = _mm256_set1_epi32(static_cast<int>(0x735a2d97));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+
+        __m256i a = _mm256_xor_si256(k, seed1);
+        a = _mm256_xor_si256(a, _mm256_srli_epi32(a, 16));
+        a = _mm256_mullo_epi32(a, c1);
+        a = _mm256_xor_si256(a, _mm256_srli_epi32(a, 13));
+        a = _mm256_mullo_epi32(a, c2);
+        a = _mm256_xor_si256(a, _mm256_srli_epi32(a, 16));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(hash1 + i), _mm256_and_si256(a, vmask));
+
+        __m256i b = _mm256_xor_si256(k, seed2);
+        b = _mm256_xor_si256(b, _mm256_srli_epi32(b, 16));
+        b = _mm256_mullo_epi32(b, d1);
+        b = _mm256_xor_si256(b, _mm256_srli_epi32(b, 15));
+        b = _mm256_mullo_epi32(b, d2);
+        b = _mm256_xor_si256(b, _mm256_srli_epi32(b, 15));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(hash2 + i),
+                            _mm256_or_si256(_mm256_and_si256(b, vmask), one));
+    }
+    hashScalar(keys + i, count - i, seed, mask, hash1 + i, hash2 + i);
+}
+
+__attribute__((target("avx512f")))
+void hashAvx512(const int *keys, int count, uint32_t seed, uint32_t mask,
+                uint32_t *hash1, uint32_t *hash2) {
+    const __m512i seed1 = _mm512_set1_epi32(static_cast<int>(seed));
+    const __m512i seed2 = _mm512_set1_epi32(static_cast<int>(seed + 0x9e3779b9));
+    const __m512i vmask = _mm512_set1_epi32(static_cast<int>(mask));
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i c1 = _mm512_set1_epi32(static_cast<int>(0x85ebca6b));
+    const __m512i c2 = _mm512_set1_epi32(static_cast<int>(0xc2b2ae35));
+    const __m512i d1 = _mm512_set1_epi32(static_cast<int>(0x21f0aaad));
+    const __m512i d2 = _mm512_set1_epi32(static_cast<int>(0x735a2d97));
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512i k = _mm512_loadu_si512(keys + i);
+
+        __m512i a = _mm512_xor_si512(k, seed1);
+        a = _mm512_xor_si512(a, _mm512_srli_epi32(a, 16));
+        a = _mm512_mullo_epi32(a, c1);
+        a = _mm512_xor_si512(a, _mm512_srli_epi32(a, 13));
+        a = _mm512_mullo_epi32(a, c2);
+        a = _mm512_xor_si512(a, _mm512_srli_epi32(a, 16));
+        _mm512_storeu_si512(hash1 + i, _mm512_and_si512(a, vmask));
+
+        __m512i b = _mm512_xor_si512(k, seed2);
+        b = _mm512_xor_si512(b, _mm512_srli_epi32(b, 16));
+        b = _mm512_mullo_epi32(b, d1);
+        b = _mm512_xor_si512(b, _mm512_srli_epi32(b, 15));
+        b = _mm512_mullo_epi32(b, d2);
+        b = _mm512_xor_si512(b, _mm512_srli_epi32(b, 15));
+        _mm512_storeu_si512(hash2 + i, _mm512_or_si512(_mm512_and_si512(b, vmask), one));
+    }
+    // 尾部交给AVX2处理，不足8个再走标量
+    hashAvx2(keys + i, count - i, seed, mask, hash1 + i, hash2 + i);
+}
+
+#endif // SHM_BATCH_HASH_X86
+
+struct BatchHashImpl {
+    BatchHashFn fn;
+    const char *name;
+};
+
+BatchHashImpl selectImpl() {
+#ifdef SHM_BATCH_HASH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {hashAvx512, "avx512"};
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return {hashAvx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return {hashSse41, "sse4.1"};
+    }
+#endif
+    return {hashScalar, "scalar"};
+}
+
+const BatchHashImpl &impl() {
+    static const BatchHashImpl selected = selectImpl();
+    return selected;
+}
+
+} // namespace
+
+void batchHash(const int *keys, int count, uint32_t seed, uint32_t mask,
+               uint32_t *hash1, uint32_t *hash2) {
+    if (count <= 0) {
+        return;
+    }
+    impl().fn(keys, count, seed, mask, hash1, hash2);
+}
+
+const char *batchHashImpl() {
+    return impl().name;
+}
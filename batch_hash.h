@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+// 双重哈希使用的两个MurmurHash3终结器（未取掩码），
+// 标量查找路径与批量向量化实现共用，保证结果逐位一致
+inline uint32_t murmurMix1(int key, uint32_t seed) {
+  uint32_t k = static_cast<uint32_t>(key);
+  k ^= seed;
+  k ^= k >> 16;
+  k *= 0x85ebca6b;
+  k ^= k >> 13;
+  k *= 0xc2b2ae35;
+  k ^= k >> 16;
+  return k;
+}
+
+inline uint32_t murmurMix2(int key, uint32_t seed) {
+  uint32_t k = static_cast<uint32_t>(key);
+  k ^= seed + 0x9e3779b9;
+  k ^= k >> 16;
+  k *= 0x21f0aaad;
+  k ^= k >> 15;
+  k *= 0x735a2d97;
+  k ^= k >> 15;
+  return k;
+}
+
+// 批量计算count个键的主/次哈希：hash1[i] = murmurMix1 & mask，
+// hash2[i] = (murmurMix2 & mask) | 1。mask为表大小减一。
+// x86上按CPU能力在首次调用时选择AVX-512/AVX2/SSE4.1实现（每次4~16个键），
+// 其他平台及剩余不足一组的键使用标量实现
+void batchHash(const int *keys, int count, uint32_t seed, uint32_t mask,
+               uint32_t *hash1, uint32_t *hash2);
+
+// 当前选用的实现："avx512"、"avx2"、"sse4.1"或"scalar"
+const char *batchHashImpl();
@@ -0,0 +1,261 @@
+#include "cold_tier.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <random>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ColdTier::ColdTier(const std::string &path, int capacity)
+    : path_(path), fd_(-1), mapped_size_(0), header_(nullptr), entries_(nullptr) {
+
+    if (capacity <= 0 || (capacity & (capacity - 1)) != 0) {
+        throw std::runtime_error("cold tier capacity must be a power of two");
+    }
+
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0666);
+    if (fd_ == -1) {
+        throw std::runtime_error("open cold tier failed: " + std::string(strerror(errno)));
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) == -1) {
+        close(fd_);
+        throw std::runtime_error("fstat cold tier failed: " + std::string(strerror(errno)));
+    }
+
+    // 调用者持有table_mutex，因此不会有两个进程同时初始化同一个文件
+    // 魔数最后写入：初始化中途崩溃留下的文件没有合法魔数，按不存在处理并重建，
+    // 只有魔数合法而容量不符的文件才视为不兼容
+    mapped_size_ = sizeof(ColdTierHeader) + sizeof(ColdEntry) * static_cast<size_t>(capacity);
+    ColdTierHeader existing;
+    bool has_magic = static_cast<size_t>(st.st_size) >= sizeof(ColdTierHeader) &&
+                     pread(fd_, &existing, sizeof(existing), 0) == static_cast<ssize_t>(sizeof(existing)) &&
+                     existing.magic == COLD_TIER_MAGIC;
+    if (has_magic && (existing.capacity != static_cast<uint32_t>(capacity) ||
+                      static_cast<size_t>(st.st_size) != mapped_size_)) {
+        close(fd_);
+        throw std::runtime_error("cold tier file has an incompatible header");
+    }
+
+    bool is_creator = !has_magic;
+    if (is_creator) {
+        // 先截断为0再扩展，残留内容全部清零，即所有槽位为EMPTY
+        if (ftruncate(fd_, 0) == -1 || ftruncate(fd_, mapped_size_) == -1) {
+            close(fd_);
+            throw std::runtime_error("ftruncate cold tier failed: " + std::string(strerror(errno)));
+        }
+    }
+
+    void *addr = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        close(fd_);
+        throw std::runtime_error("mmap cold tier failed: " + std::string(strerror(errno)));
+    }
+    header_ = static_cast<ColdTierHeader *>(addr);
+    entries_ = reinterpret_cast<ColdEntry *>(static_cast<char *>(addr) + sizeof(ColdTierHeader));
+
+    if (is_creator) {
+        std::random_device rd;
+        header_->capacity = static_cast<uint32_t>(capacity);
+        header_->hash_seed = rd();
+        header_->current_count.store(0, std::memory_order_relaxed);
+        header_->deleted_count = 0;
+        std::atomic_thread_fence(std::memory_order_release);
+        header_->magic = COLD_TIER_MAGIC;
+    }
+}
+
+ColdTier::~ColdTier() {
+    if (header_ != nullptr) {
+        munmap(header_, mapped_size_);
+    }
+    if (fd_ != -1) {
+        close(fd_);
+    }
+}
+
+uint32_t ColdTier::hash(int key) const {
+    uint32_t k = static_cast<uint32_t>(key);
+    k ^= header_->hash_seed;
+    k ^= k >> 16;
+    k *= 0x85ebca6b;
+    k ^= k >> 13;
+    k *= 0xc2b2ae35;
+    k ^= k >> 16;
+    return k & (header_->capacity - 1);
+}
+
+int ColdTier::findEntry(int key) const {
+    // 冷数据访问频率低，使用线性探测即可
+    uint32_t mask = header_->capacity - 1;
+    uint32_t pos = hash(key);
+
+    for (uint32_t step = 0; step < header_->capacity; ++step) {
+        const ColdEntry &entry = entries_[pos];
+        if (entry.state == EMPTY) {
+            return -1;
+        }
+        if (entry.state == OCCUPIED && entry.key == key) {
+            return static_cast<int>(pos);
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+int ColdTier::findEmptySlot(int key) const {
+    uint32_t mask = header_->capacity - 1;
+    uint32_t pos = hash(key);
+    int first_deleted = -1;
+
+    for (uint32_t step = 0; step < header_->capacity; ++step) {
+        const ColdEntry &entry = entries_[pos];
+        if (entry.state == EMPTY) {
+            return first_deleted != -1 ? first_deleted : static_cast<int>(pos);
+        }
+        if (entry.state == DELETED && first_deleted == -1) {
+            first_deleted = static_cast<int>(pos);
+        }
+        pos = (pos + 1) & mask;
+    }
+    return first_deleted;
+}
+
+// 压缩期间标记待重新放置的条目，只在compact()内部出现
+const EntryState COLD_REHASHING = static_cast<EntryState>(3);
+
+void ColdTier::compact() {
+    // 原地重排，持有table_mutex期间不分配内存：
+    // 先把DELETED清为EMPTY、OCCUPIED标为待放置，再逐个放到探测链上第一个
+    // 非OCCUPIED的槽位；目标是待放置条目时交换并继续放置被换出的条目。
+    // 已放置条目的探测链上只有OCCUPIED槽位，之后不会再被清空，因此始终可达
+    for (uint32_t i = 0; i < header_->capacity; ++i) {
+        ColdEntry &entry = entries_[i];
+        entry.state = entry.state == OCCUPIED ? COLD_REHASHING : EMPTY;
+    }
+
+    uint32_t mask = header_->capacity - 1;
+    for (uint32_t i = 0; i < header_->capacity; ++i) {
+        while (entries_[i].state == COLD_REHASHING) {
+            uint32_t target = hash(entries_[i].key);
+            while (entries_[target].state == OCCUPIED) {
+                target = (target + 1) & mask;
+            }
+            if (target == i) {
+                entries_[i].state = OCCUPIED;
+            } else if (entries_[target].state == EMPTY) {
+                entries_[target] = entries_[i];
+                entries_[target].state = OCCUPIED;
+                entries_[i].state = EMPTY;
+            } else {
+                ColdEntry displaced = entries_[target];
+                entries_[target] = entries_[i];
+                entries_[target].state = OCCUPIED;
+                entries_[i] = displaced;
+            }
+        }
+    }
+    header_->deleted_count = 0;
+}
+
+bool ColdTier::get(int key, std::string *value) const {
+    int pos = findEntry(key);
+    if (pos == -1) {
+        return false;
+    }
+    if (value != nullptr) {
+        value->assign(entries_[pos].value);
+    }
+    return true;
+}
+
+int ColdTier::put(int key, const char *value) {
+    int pos = findEntry(key);
+    if (pos != -1) {
+        strncpy(entries_[pos].value, value, MAX_VALUE_LEN - 1);
+        entries_[pos].value[MAX_VALUE_LEN - 1] = '\0';
+        return OK;
+    }
+
+    int limit = static_cast<int>(header_->capacity * COLD_TIER_MAX_LOAD_FACTOR);
+    if (count() >= limit) {
+        return NO_SPACE_ERR;
+    }
+    if (count() + header_->deleted_count >= limit) {
+        compact();
+    }
+
+    pos = findEmptySlot(key);
+    if (pos == -1) {
+        return NO_SPACE_ERR;
+    }
+
+    ColdEntry &entry = entries_[pos];
+    if (entry.state == DELETED) {
+        header_->deleted_count--;
+    }
+    entry.key = key;
+    strncpy(entry.value, value, MAX_VALUE_LEN - 1);
+    entry.value[MAX_VALUE_LEN - 1] = '\0';
+    entry.state = OCCUPIED;
+    header_->current_count.fetch_add(1, std::memory_order_relaxed);
+    return OK;
+}
+
+int ColdTier::update(int key, const char *value) {
+    int pos = findEntry(key);
+    if (pos == -1) {
+        return NOT_FOUND;
+    }
+    strncpy(entries_[pos].value, value, MAX_VALUE_LEN - 1);
+    entries_[pos].value[MAX_VALUE_LEN - 1] = '\0';
+    return OK;
+}
+
+int ColdTier::remove(int key) {
+    int pos = findEntry(key);
+    if (pos == -1) {
+        return NOT_FOUND;
+    }
+    entries_[pos].state = DELETED;
+    header_->current_count.fetch_sub(1, std::memory_order_relaxed);
+    header_->deleted_count++;
+    return OK;
+}
+
+void ColdTier::clear() {
+    for (uint32_t i = 0; i < header_->capacity; ++i) {
+        entries_[i].state = EMPTY;
+    }
+    header_->current_count.store(0, std::memory_order_relaxed);
+    header_->deleted_count = 0;
+}
+
+void ColdTier::collect(std::map<int, std::string> &out) const {
+    collect(out, 0, capacity());
+}
+
+void ColdTier::collect(std::map<int, std::string> &out, int begin, int end) const {
+    if (end > capacity()) {
+        end = capacity();
+    }
+    for (int i = begin < 0 ? 0 : begin; i < end; ++i) {
+        if (entries_[i].state == OCCUPIED) {
+            out[entries_[i].key] = entries_[i].value;
+        }
+    }
+}
+
+void ColdTier::collect(ScanArena &out, int begin, int end) const {
+    if (end > capacity()) {
+        end = capacity();
+    }
+    for (int i = begin < 0 ? 0 : begin; i < end; ++i) {
+        if (entries_[i].state == OCCUPIED) {
+            out.append(entries_[i].key, entries_[i].value, strnlen(entries_[i].value, MAX_VALUE_LEN));
+        }
+    }
+}
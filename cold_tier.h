@@ -0,0 +1,66 @@
+#pragma once
+
+#include "optimized_status.h"
+#include "table_scan.h"
+#include <atomic>
+#include <map>
+#include <string>
+
+// 冷数据层：文件映射的二级哈希表，容纳从共享内存表中降级的冷条目
+// 不自带锁，所有访问都必须持有所属键空间的table_mutex
+const uint32_t COLD_TIER_MAGIC = 0x434f4c44; // "COLD"
+const double COLD_TIER_MAX_LOAD_FACTOR = 0.75;
+
+struct ColdTierHeader {
+  uint32_t magic;
+  uint32_t capacity; // 槽位数，2的幂次
+  uint32_t hash_seed;
+  std::atomic<int> current_count; // rscNum()无锁读取
+  int deleted_count;
+};
+
+struct ColdEntry {
+  int key;
+  EntryState state;
+  char value[MAX_VALUE_LEN];
+};
+
+class ColdTier {
+public:
+  // 打开或创建冷数据文件，失败时抛出std::runtime_error
+  ColdTier(const std::string &path, int capacity);
+  ~ColdTier();
+
+  ColdTier(const ColdTier &) = delete;
+  ColdTier &operator=(const ColdTier &) = delete;
+
+  bool get(int key, std::string *value) const;
+  int put(int key, const char *value);      // 插入或覆盖
+  int update(int key, const char *value);   // 仅更新已存在的键
+  int remove(int key);
+  void clear();
+  void collect(std::map<int, std::string> &out) const;
+  // 只收集槽位[begin, end)中的条目，用于分段读取
+  void collect(std::map<int, std::string> &out, int begin, int end) const;
+  // 追加到扫描输出区，供并行扫描按槽位分段使用
+  void collect(ScanArena &out, int begin, int end) const;
+
+  int count() const {
+    return header_->current_count.load(std::memory_order_relaxed);
+  }
+  int capacity() const { return static_cast<int>(header_->capacity); }
+  const std::string &path() const { return path_; }
+
+private:
+  uint32_t hash(int key) const;
+  int findEntry(int key) const;
+  int findEmptySlot(int key) const;
+  void compact();
+
+private:
+  std::string path_;
+  int fd_;
+  size_t mapped_size_;
+  ColdTierHeader *header_;
+  ColdEntry *entries_;
+};
@@ -0,0 +1,707 @@
+#include "cuckoo_status.h"
+#include "shm_common.h"
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sched.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char *const SHM_NAME = "/cuckoo_status_memory";
+
+std::string segmentName(const std::string &name) {
+    return std::string(SHM_NAME) + "_" + name;
+}
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+} // namespace
+
+CuckooStatusRscManager &CuckooStatusRscManager::getInstance() {
+    static CuckooStatusRscManager instance(SHM_NAME);
+    return instance;
+}
+
+CuckooStatusRscManager &CuckooStatusRscManager::getInstance(const std::string &name) {
+    static std::mutex instances_mutex;
+    static std::map<std::string, std::unique_ptr<CuckooStatusRscManager>> instances;
+
+    std::lock_guard<std::mutex> guard(instances_mutex);
+    auto it = instances.find(name);
+    if (it != instances.end()) {
+        return *it->second;
+    }
+    if (name.empty() || name.find('/') != std::string::npos || segmentName(name).length() > NAME_MAX) {
+        throw std::runtime_error("invalid cuckoo segment name: " + name);
+    }
+
+    std::unique_ptr<CuckooStatusRscManager> manager(new CuckooStatusRscManager(segmentName(name)));
+    CuckooStatusRscManager &result = *manager;
+    instances[name] = std::move(manager);
+    return result;
+}
+
+CuckooStatusRscManager::CuckooStatusRscManager(const std::string &shm_name)
+    : shm_name_(shm_name), shared_data_(nullptr), shm_fd_(-1), is_creator_(false) {
+
+    // 尝试打开已存在的共享内存
+    shm_fd_ = shm_open(shm_name_.c_str(), O_RDWR, 0666);
+
+    if (shm_fd_ == -1) {
+        // 共享内存不存在，创建新的
+        shm_fd_ = shm_open(shm_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+        if (shm_fd_ == -1) {
+            if (errno == EEXIST) {
+                // 其他进程刚刚创建了，重新尝试打开
+                shm_fd_ = shm_open(shm_name_.c_str(), O_RDWR, 0666);
+            }
+            if (shm_fd_ == -1) {
+                throw std::runtime_error("shm_open failed: " + std::string(strerror(errno)));
+            }
+        } else {
+            is_creator_ = true;
+        }
+    }
+
+    // 如果是创建者，设置大小
+    if (is_creator_) {
+        if (ftruncate(shm_fd_, sizeof(CuckooSharedData)) == -1) {
+            close(shm_fd_);
+            shm_unlink(shm_name_.c_str());
+            throw std::runtime_error("ftruncate failed: " + std::string(strerror(errno)));
+        }
+    }
+
+    // 映射共享内存
+    shared_data_ = static_cast<CuckooSharedData *>(
+        mmap(nullptr, sizeof(CuckooSharedData), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0));
+
+    if (shared_data_ == MAP_FAILED) {
+        close(shm_fd_);
+        if (is_creator_) {
+            shm_unlink(shm_name_.c_str());
+        }
+        throw std::runtime_error("mmap failed: " + std::string(strerror(errno)));
+    }
+
+    // 初始化共享数据
+    if (is_creator_) {
+        initSharedMutex(&shared_data_->table_mutex, false, true);
+
+        shared_data_->current_count.store(0, std::memory_order_relaxed);
+        for (int i = 0; i < CUCKOO_VERSION_STRIPES; ++i) {
+            shared_data_->versions[i].store(0, std::memory_order_relaxed);
+        }
+
+        // 生成随机哈希种子
+        std::random_device rd;
+        shared_data_->hash_seed = rd();
+
+        // 初始化所有槽位为空（标签为0）
+        for (int b = 0; b < CUCKOO_BUCKET_COUNT; ++b) {
+            for (int s = 0; s < CUCKOO_SLOTS_PER_BUCKET; ++s) {
+                shared_data_->buckets[b].tags[s].store(0, std::memory_order_relaxed);
+                shared_data_->buckets[b].keys[s].store(0, std::memory_order_relaxed);
+                shared_data_->buckets[b].values[s][0] = '\0';
+            }
+        }
+
+        // 标记初始化完成
+        std::atomic_thread_fence(std::memory_order_release);
+        shared_data_->initialized = true;
+    } else {
+        // 等待初始化完成
+        while (!shared_data_->initialized) {
+            usleep(1000);  // 等待1ms
+        }
+    }
+}
+
+CuckooStatusRscManager::~CuckooStatusRscManager() {
+    if (shared_data_ != nullptr && shared_data_ != MAP_FAILED) {
+        munmap(shared_data_, sizeof(CuckooSharedData));
+    }
+    if (shm_fd_ != -1) {
+        close(shm_fd_);
+    }
+}
+
+int CuckooStatusRscManager::cleanup() {
+    if (shm_unlink(SHM_NAME) == -1) {
+        if (errno != ENOENT) {
+            return -1;
+        }
+    }
+    return OK;
+}
+
+int CuckooStatusRscManager::cleanup(const std::string &name) {
+    if (shm_unlink(segmentName(name).c_str()) == -1) {
+        if (errno != ENOENT) {
+            return -1;
+        }
+    }
+    return OK;
+}
+
+uint32_t CuckooStatusRscManager::hash(int key) const {
+    // 与默认引擎相同的MurmurHash3终结函数
+    uint32_t k = static_cast<uint32_t>(key);
+    k ^= shared_data_->hash_seed;
+    k ^= k >> 16;
+    k *= 0x85ebca6b;
+    k ^= k >> 13;
+    k *= 0xc2b2ae35;
+    k ^= k >> 16;
+    return k;
+}
+
+uint8_t CuckooStatusRscManager::tagOf(uint32_t hash_val) {
+    // 取高8位作为标签，0保留给空槽
+    uint8_t tag = static_cast<uint8_t>(hash_val >> 24);
+    return tag == 0 ? 1 : tag;
+}
+
+int CuckooStatusRscManager::primaryBucket(uint32_t hash_val) {
+    return static_cast<int>(hash_val & (CUCKOO_BUCKET_COUNT - 1));
+}
+
+int CuckooStatusRscManager::altBucket(int bucket, uint8_t tag) {
+    // 部分键布谷鸟哈希：altBucket(altBucket(b, t), t) == b
+    return static_cast<int>((static_cast<uint32_t>(bucket) ^ (tag * 0x5bd1e995u)) &
+                            (CUCKOO_BUCKET_COUNT - 1));
+}
+
+int CuckooStatusRscManager::stripeOf(int bucket) {
+    return bucket & (CUCKOO_VERSION_STRIPES - 1);
+}
+
+bool CuckooStatusRscManager::optimisticFind(int key, std::string *value) const {
+    uint32_t hash_val = hash(key);
+    uint8_t tag = tagOf(hash_val);
+    int b1 = primaryBucket(hash_val);
+    int b2 = altBucket(b1, tag);
+    const std::atomic<uint32_t> &ver1 = shared_data_->versions[stripeOf(b1)];
+    const std::atomic<uint32_t> &ver2 = shared_data_->versions[stripeOf(b2)];
+    char buffer[MAX_VALUE_LEN];
+
+    for (int retries = 0;; ++retries) {
+        // 写者可能在修改中途退出，条带永远为奇数；重试有上限，之后持锁读取并修复
+        if (retries >= CUCKOO_READ_RETRY_LIMIT) {
+            return lockedFind(key, value);
+        }
+        if (retries >= CUCKOO_READ_SPIN_LIMIT) {
+            sched_yield();
+        } else if (retries > 0) {
+            cpuRelax();
+        }
+
+        uint32_t v1 = ver1.load(std::memory_order_acquire);
+        uint32_t v2 = ver2.load(std::memory_order_acquire);
+        if ((v1 & 1) || (v2 & 1)) {
+            continue;  // 写者正在修改，重试
+        }
+
+        bool found = false;
+        const int candidates[2] = {b1, b2};
+        for (int c = 0; c < 2 && !found; ++c) {
+            const CuckooBucket &bucket = shared_data_->buckets[candidates[c]];
+            for (int s = 0; s < CUCKOO_SLOTS_PER_BUCKET; ++s) {
+                if (bucket.tags[s].load(std::memory_order_relaxed) != tag ||
+                    bucket.keys[s].load(std::memory_order_relaxed) != key) {
+                    continue;
+                }
+                if (value != nullptr) {
+                    memcpy(buffer, bucket.values[s], MAX_VALUE_LEN);
+                    buffer[MAX_VALUE_LEN - 1] = '\0';
+                }
+                found = true;
+                break;
+            }
+        }
+
+        // 版本未变化则读到的是一致的快照
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (ver1.load(std::memory_order_relaxed) == v1 &&
+            ver2.load(std::memory_order_relaxed) == v2) {
+            if (found && value != nullptr) {
+                value->assign(buffer);
+            }
+            return found;
+        }
+    }
+}
+
+bool CuckooStatusRscManager::lockedFind(int key, std::string *value) const {
+    lockTable();
+    int bucket = 0;
+    int slot = 0;
+    bool found = findSlot(key, bucket, slot);
+    if (found && value != nullptr) {
+        const char *stored = shared_data_->buckets[bucket].values[slot];
+        value->assign(stored, strnlen(stored, MAX_VALUE_LEN));
+    }
+    unlockTable();
+    return found;
+}
+
+void CuckooStatusRscManager::lockTable() const {
+    if (pthread_mutex_lock(&shared_data_->table_mutex) == EOWNERDEAD) {
+        recoverAfterOwnerDeath();
+        pthread_mutex_consistent(&shared_data_->table_mutex);
+    }
+}
+
+void CuckooStatusRscManager::unlockTable() const {
+    pthread_mutex_unlock(&shared_data_->table_mutex);
+}
+
+void CuckooStatusRscManager::recoverAfterOwnerDeath() const {
+    // 写者只在持锁时使条带变为奇数，恢复为偶数后乐观读不再等待。
+    // 移动条目中途退出会留下同一键的两份拷贝，保留先找到的一份；
+    // 写值中途退出时该条目的值可能不完整
+    for (int i = 0; i < CUCKOO_VERSION_STRIPES; ++i) {
+        if (shared_data_->versions[i].load(std::memory_order_relaxed) & 1) {
+            shared_data_->versions[i].fetch_add(1, std::memory_order_release);
+        }
+    }
+    int count = 0;
+    for (int b = 0; b < CUCKOO_BUCKET_COUNT; ++b) {
+        for (int s = 0; s < CUCKOO_SLOTS_PER_BUCKET; ++s) {
+            uint8_t tag = shared_data_->buckets[b].tags[s].load(std::memory_order_relaxed);
+            if (tag == 0) {
+                continue;
+            }
+            count++;
+            int key = shared_data_->buckets[b].keys[s].load(std::memory_order_relaxed);
+            const int candidates[2] = {b, altBucket(b, tag)};
+            for (int c = 0; c < 2; ++c) {
+                CuckooBucket &other = shared_data_->buckets[candidates[c]];
+                for (int t = 0; t < CUCKOO_SLOTS_PER_BUCKET; ++t) {
+                    if ((candidates[c] != b || t != s) &&
+                        other.tags[t].load(std::memory_order_relaxed) == tag &&
+                        other.keys[t].load(std::memory_order_relaxed) == key) {
+                        other.tags[t].store(0, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+    }
+    shared_data_->current_count.store(count, std::memory_order_relaxed);
+    std::cerr << "Cuckoo table writer died while holding the lock, recovered " << count
+              << " entries" << std::endl;
+}
+
+void CuckooStatusRscManager::beginWrite(int b1, int b2) {
+    int s1 = stripeOf(b1);
+    int s2 = stripeOf(b2);
+    shared_data_->versions[s1].fetch_add(1, std::memory_order_acq_rel);
+    if (s2 != s1) {
+        shared_data_->versions[s2].fetch_add(1, std::memory_order_acq_rel);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void CuckooStatusRscManager::endWrite(int b1, int b2) {
+    int s1 = stripeOf(b1);
+    int s2 = stripeOf(b2);
+    shared_data_->versions[s1].fetch_add(1, std::memory_order_release);
+    if (s2 != s1) {
+        shared_data_->versions[s2].fetch_add(1, std::memory_order_release);
+    }
+}
+
+bool CuckooStatusRscManager::findSlot(int key, int &bucket, int &slot) const {
+    uint32_t hash_val = hash(key);
+    uint8_t tag = tagOf(hash_val);
+    int b1 = primaryBucket(hash_val);
+    const int candidates[2] = {b1, altBucket(b1, tag)};
+
+    for (int c = 0; c < 2; ++c) {
+        const CuckooBucket &entry = shared_data_->buckets[candidates[c]];
+        for (int s = 0; s < CUCKOO_SLOTS_PER_BUCKET; ++s) {
+            if (entry.tags[s].load(std::memory_order_relaxed) == tag &&
+                entry.keys[s].load(std::memory_order_relaxed) == key) {
+                bucket = candidates[c];
+                slot = s;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+int CuckooStatusRscManager::findFreeSlot(int bucket) const {
+    const CuckooBucket &entry = shared_data_->buckets[bucket];
+    for (int s = 0; s < CUCKOO_SLOTS_PER_BUCKET; ++s) {
+        if (entry.tags[s].load(std::memory_order_relaxed) == 0) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+bool CuckooStatusRscManager::moveEntry(int from_bucket, int from_slot, int to_bucket, int to_slot) {
+    CuckooBucket &from = shared_data_->buckets[from_bucket];
+    CuckooBucket &to = shared_data_->buckets[to_bucket];
+    uint8_t tag = from.tags[from_slot].load(std::memory_order_relaxed);
+
+    // 路径执行期间槽位内容可能已变化，只允许在条目的两个候选桶之间移动
+    if (tag == 0 || to.tags[to_slot].load(std::memory_order_relaxed) != 0 ||
+        altBucket(from_bucket, tag) != to_bucket) {
+        return false;
+    }
+
+    beginWrite(from_bucket, to_bucket);
+    to.keys[to_slot].store(from.keys[from_slot].load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+    memcpy(to.values[to_slot], from.values[from_slot], MAX_VALUE_LEN);
+    to.tags[to_slot].store(tag, std::memory_order_relaxed);
+    from.tags[from_slot].store(0, std::memory_order_relaxed);
+    endWrite(from_bucket, to_bucket);
+    return true;
+}
+
+bool CuckooStatusRscManager::makeRoom(int b1, int b2, int &bucket, int &slot) {
+    struct PathStep {
+        int bucket;
+        int slot;
+    };
+    static thread_local std::minstd_rand rng(std::random_device{}());
+    PathStep path[CUCKOO_MAX_PATH_LEN];
+
+    for (int attempt = 0; attempt < CUCKOO_MAX_PATH_ATTEMPTS; ++attempt) {
+        // 先随机游走找出一条以空槽结尾的路径，不修改任何数据
+        int current = (rng() & 1) ? b1 : b2;
+        int depth = 0;
+        int free_slot = -1;
+        while (depth < CUCKOO_MAX_PATH_LEN) {
+            free_slot = findFreeSlot(current);
+            if (free_slot != -1) {
+                break;
+            }
+
+            int victim = static_cast<int>(rng() % CUCKOO_SLOTS_PER_BUCKET);
+            bool revisited = false;
+            for (int i = 0; i < depth; ++i) {
+                if (path[i].bucket == current && path[i].slot == victim) {
+                    revisited = true;
+                    break;
+                }
+            }
+            if (revisited) {
+                victim = (victim + 1) % CUCKOO_SLOTS_PER_BUCKET;
+            }
+
+            path[depth].bucket = current;
+            path[depth].slot = victim;
+            ++depth;
+            uint8_t tag = shared_data_->buckets[current].tags[victim].load(std::memory_order_relaxed);
+            current = altBucket(current, tag);
+        }
+        if (free_slot == -1) {
+            continue;
+        }
+
+        // 从路径末端向前逐个搬移，每一步都只让一个条目在其两个候选桶之间移动
+        int to_bucket = current;
+        int to_slot = free_slot;
+        bool moved_all = true;
+        for (int i = depth - 1; i >= 0; --i) {
+            if (!moveEntry(path[i].bucket, path[i].slot, to_bucket, to_slot)) {
+                moved_all = false;
+                break;
+            }
+            to_bucket = path[i].bucket;
+            to_slot = path[i].slot;
+        }
+        if (moved_all) {
+            bucket = to_bucket;
+            slot = to_slot;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CuckooStatusRscManager::writeSlot(int bucket, int slot, int key, uint8_t tag,
+                                       const std::string &value) {
+    CuckooBucket &entry = shared_data_->buckets[bucket];
+    beginWrite(bucket, bucket);
+    entry.keys[slot].store(key, std::memory_order_relaxed);
+    strncpy(entry.values[slot], value.c_str(), MAX_VALUE_LEN - 1);
+    entry.values[slot][MAX_VALUE_LEN - 1] = '\0';
+    entry.tags[slot].store(tag, std::memory_order_relaxed);
+    endWrite(bucket, bucket);
+}
+
+int CuckooStatusRscManager::insertLocked(int key, const std::string &value) {
+    if (shared_data_->current_count.load(std::memory_order_relaxed) >= CUCKOO_MAX_ENTRIES) {
+        return NO_SPACE_ERR;
+    }
+
+    uint32_t hash_val = hash(key);
+    uint8_t tag = tagOf(hash_val);
+    int b1 = primaryBucket(hash_val);
+    int b2 = altBucket(b1, tag);
+
+    int bucket = b1;
+    int slot = findFreeSlot(b1);
+    if (slot == -1) {
+        bucket = b2;
+        slot = findFreeSlot(b2);
+    }
+    if (slot == -1 && !makeRoom(b1, b2, bucket, slot)) {
+        return NO_SPACE_ERR;
+    }
+
+    writeSlot(bucket, slot, key, tag, value);
+    shared_data_->current_count.fetch_add(1, std::memory_order_relaxed);
+    return OK;
+}
+
+// 实现接口方法
+int CuckooStatusRscManager::addRsc(int rsc_key, const std::string &rsc_value) {
+    if (rsc_value.empty()) return -1;
+
+    if (rsc_value.length() >= MAX_VALUE_LEN) {
+        return NO_SPACE_ERR;
+    }
+
+    lockTable();
+
+    int bucket = 0;
+    int slot = 0;
+    if (findSlot(rsc_key, bucket, slot)) {
+        unlockTable();
+        return DUPLICATE_KEY;
+    }
+
+    int result = insertLocked(rsc_key, rsc_value);
+    unlockTable();
+    return result;
+}
+
+std::string CuckooStatusRscManager::getRsc(int rsc_key) {
+    std::string result;
+    optimisticFind(rsc_key, &result);
+    return result;
+}
+
+int CuckooStatusRscManager::updateRsc(int rsc_key, const std::string &rsc_value) {
+    if (rsc_value.empty()) return -1;
+
+    if (rsc_value.length() >= MAX_VALUE_LEN) {
+        return NO_SPACE_ERR;
+    }
+
+    lockTable();
+
+    int bucket = 0;
+    int slot = 0;
+    if (!findSlot(rsc_key, bucket, slot)) {
+        unlockTable();
+        return NOT_FOUND;
+    }
+
+    uint8_t tag = shared_data_->buckets[bucket].tags[slot].load(std::memory_order_relaxed);
+    writeSlot(bucket, slot, rsc_key, tag, rsc_value);
+
+    unlockTable();
+    return OK;
+}
+
+int CuckooStatusRscManager::upsertRsc(int rsc_key, const std::string &rsc_value) {
+    if (rsc_value.empty()) return -1;
+
+    if (rsc_value.length() >= MAX_VALUE_LEN) {
+        return NO_SPACE_ERR;
+    }
+
+    lockTable();
+
+    int bucket = 0;
+    int slot = 0;
+    int result = OK;
+    if (findSlot(rsc_key, bucket, slot)) {
+        uint8_t tag = shared_data_->buckets[bucket].tags[slot].load(std::memory_order_relaxed);
+        writeSlot(bucket, slot, rsc_key, tag, rsc_value);
+    } else {
+        result = insertLocked(rsc_key, rsc_value);
+    }
+
+    unlockTable();
+    return result;
+}
+
+int CuckooStatusRscManager::removeRsc(int rsc_key) {
+    lockTable();
+
+    int bucket = 0;
+    int slot = 0;
+    if (!findSlot(rsc_key, bucket, slot)) {
+        unlockTable();
+        return NOT_FOUND;
+    }
+
+    // 布谷鸟哈希不需要删除标记，直接清空标签
+    beginWrite(bucket, bucket);
+    shared_data_->buckets[bucket].tags[slot].store(0, std::memory_order_relaxed);
+    endWrite(bucket, bucket);
+    shared_data_->current_count.fetch_sub(1, std::memory_order_relaxed);
+
+    unlockTable();
+    return OK;
+}
+
+int CuckooStatusRscManager::isContain(int rsc_key) {
+    return optimisticFind(rsc_key, nullptr);
+}
+
+int CuckooStatusRscManager::rscNum() {
+    return shared_data_->current_count.load(std::memory_order_relaxed);
+}
+
+int CuckooStatusRscManager::clearRsc() {
+    lockTable();
+
+    for (int i = 0; i < CUCKOO_VERSION_STRIPES; ++i) {
+        shared_data_->versions[i].fetch_add(1, std::memory_order_acq_rel);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int b = 0; b < CUCKOO_BUCKET_COUNT; ++b) {
+        for (int s = 0; s < CUCKOO_SLOTS_PER_BUCKET; ++s) {
+            shared_data_->buckets[b].tags[s].store(0, std::memory_order_relaxed);
+        }
+    }
+    shared_data_->current_count.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < CUCKOO_VERSION_STRIPES; ++i) {
+        shared_data_->versions[i].fetch_add(1, std::memory_order_release);
+    }
+
+    unlockTable();
+    return OK;
+}
+
+double CuckooStatusRscManager::getLoadFactor() {
+    return static_cast<double>(rscNum()) / (CUCKOO_BUCKET_COUNT * CUCKOO_SLOTS_PER_BUCKET);
+}
+
+int CuckooStatusRscManager::batchUpdateRsc(const std::map<int, std::string> &updated_map) {
+    lockTable();
+
+    int success_count = 0;
+    for (const auto &pair : updated_map) {
+        if (pair.second.length() >= MAX_VALUE_LEN) {
+            continue;
+        }
+
+        int bucket = 0;
+        int slot = 0;
+        if (findSlot(pair.first, bucket, slot)) {
+            uint8_t tag = shared_data_->buckets[bucket].tags[slot].load(std::memory_order_relaxed);
+            writeSlot(bucket, slot, pair.first, tag, pair.second);
+            success_count++;
+        }
+    }
+
+    unlockTable();
+    return success_count;
+}
+
+int CuckooStatusRscManager::batchUpsertRsc(const std::map<int, std::string> &upserted_map) {
+    lockTable();
+
+    int success_count = 0;
+    for (const auto &pair : upserted_map) {
+        if (pair.second.empty() || pair.second.length() >= MAX_VALUE_LEN) {
+            continue;
+        }
+
+        int bucket = 0;
+        int slot = 0;
+        if (findSlot(pair.first, bucket, slot)) {
+            uint8_t tag = shared_data_->buckets[bucket].tags[slot].load(std::memory_order_relaxed);
+            writeSlot(bucket, slot, pair.first, tag, pair.second);
+            success_count++;
+        } else if (insertLocked(pair.first, pair.second) == OK) {
+            success_count++;
+        }
+    }
+
+    unlockTable();
+    return success_count;
+}
+
+int CuckooStatusRscManager::batchGetRsc(std::map<int, std::string> &fetched_map) {
+    // 持有写者锁得到一致的全表快照
+    lockTable();
+
+    fetched_map.clear();
+    for (int b = 0; b < CUCKOO_BUCKET_COUNT; ++b) {
+        const CuckooBucket &bucket = shared_data_->buckets[b];
+        for (int s = 0; s < CUCKOO_SLOTS_PER_BUCKET; ++s) {
+            if (bucket.tags[s].load(std::memory_order_relaxed) != 0) {
+                fetched_map[bucket.keys[s].load(std::memory_order_relaxed)] = bucket.values[s];
+            }
+        }
+    }
+
+    unlockTable();
+    return fetched_map.size();
+}
+
+void CuckooStatusRscManager::printStats() {
+    lockTable();
+
+    std::cout << "=== Cuckoo Hash Table Statistics ===" << std::endl;
+    std::cout << "Buckets: " << CUCKOO_BUCKET_COUNT << " x " << CUCKOO_SLOTS_PER_BUCKET
+              << " slots" << std::endl;
+    std::cout << "Current Count: " << rscNum() << std::endl;
+    std::cout << "Load Factor: " << getLoadFactor() << std::endl;
+    std::cout << "Hash Seed: " << shared_data_->hash_seed << std::endl;
+
+    // 桶填充度分布与条目所在桶（主桶/备用桶）统计
+    int fill_histogram[CUCKOO_SLOTS_PER_BUCKET + 1] = {0};
+    int in_primary = 0;
+    int in_alternate = 0;
+    for (int b = 0; b < CUCKOO_BUCKET_COUNT; ++b) {
+        const CuckooBucket &bucket = shared_data_->buckets[b];
+        int used = 0;
+        for (int s = 0; s < CUCKOO_SLOTS_PER_BUCKET; ++s) {
+            if (bucket.tags[s].load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            used++;
+            uint32_t hash_val = hash(bucket.keys[s].load(std::memory_order_relaxed));
+            if (primaryBucket(hash_val) == b) {
+                in_primary++;
+            } else {
+                in_alternate++;
+            }
+        }
+        fill_histogram[used]++;
+    }
+
+    for (int i = 0; i <= CUCKOO_SLOTS_PER_BUCKET; ++i) {
+        std::cout << "Buckets With " << i << " Entries: " << fill_histogram[i] << std::endl;
+    }
+    std::cout << "Entries In Primary Bucket: " << in_primary << std::endl;
+    std::cout << "Entries In Alternate Bucket: " << in_alternate << std::endl;
+
+    unlockTable();
+}
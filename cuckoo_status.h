@@ -0,0 +1,113 @@
+#pragma once
+
+#include "optimized_status.h"
+
+// 4路组相联布谷鸟哈希引擎（MemC3/libcuckoo风格）
+// 查找最多访问两个桶，读者不加锁，依靠版本计数器做乐观校验
+const int CUCKOO_SLOTS_PER_BUCKET = 4;
+const int CUCKOO_BUCKET_COUNT =
+    HASH_TABLE_SIZE / CUCKOO_SLOTS_PER_BUCKET; // 与默认引擎槽位总数相同
+const int CUCKOO_VERSION_STRIPES = 256;        // 版本计数器条带数，2的幂次
+const int CUCKOO_MAX_PATH_LEN = 256;           // 单次布谷鸟路径的最大长度
+const int CUCKOO_MAX_PATH_ATTEMPTS = 4;
+const double CUCKOO_MAX_LOAD_FACTOR = 0.95;
+// 乐观读遇到奇数版本时先自旋，再让出CPU，超过上限后改为持锁读取
+const int CUCKOO_READ_SPIN_LIMIT = 64;
+const int CUCKOO_READ_RETRY_LIMIT = 1024;
+const int CUCKOO_MAX_ENTRIES = static_cast<int>(
+    CUCKOO_BUCKET_COUNT * CUCKOO_SLOTS_PER_BUCKET * CUCKOO_MAX_LOAD_FACTOR);
+
+static_assert((CUCKOO_BUCKET_COUNT & (CUCKOO_BUCKET_COUNT - 1)) == 0,
+              "CUCKOO_BUCKET_COUNT must be a power of two");
+
+struct CuckooBucket {
+  // 标签与键位于桶的第一个缓存行，标签不匹配时无需读取键和值
+  alignas(CACHE_LINE_SIZE) std::atomic<uint8_t> tags[CUCKOO_SLOTS_PER_BUCKET];
+  std::atomic<int> keys[CUCKOO_SLOTS_PER_BUCKET];
+  char values[CUCKOO_SLOTS_PER_BUCKET][MAX_VALUE_LEN];
+};
+
+struct CuckooSharedData {
+  // 只读为主区域
+  alignas(CACHE_LINE_SIZE) volatile bool initialized;
+  uint32_t hash_seed;
+
+  // 写者互斥锁与计数器；读者从不获取该锁
+  alignas(CACHE_LINE_SIZE) pthread_mutex_t table_mutex;
+  std::atomic<int> current_count;
+
+  // 奇数表示对应条带的桶正在被修改
+  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> versions[CUCKOO_VERSION_STRIPES];
+
+  CuckooBucket buckets[CUCKOO_BUCKET_COUNT];
+};
+
+class CuckooStatusRscManager : public ISharedMemoryManager {
+public:
+  static CuckooStatusRscManager &getInstance();
+  // 名为name的独立段，不存在则创建；供基准与测试使用，不触及默认段中的数据
+  static CuckooStatusRscManager &getInstance(const std::string &name);
+
+  ~CuckooStatusRscManager();
+  CuckooStatusRscManager(const CuckooStatusRscManager &) = delete;
+  CuckooStatusRscManager &operator=(const CuckooStatusRscManager &) = delete;
+
+  // 实现接口方法
+  int addRsc(int key, const std::string &value) override;
+  std::string getRsc(int key) override;
+  int updateRsc(int key, const std::string &value) override;
+  int upsertRsc(int key, const std::string &value) override;
+  int removeRsc(int key) override;
+  int isContain(int key) override;
+  int rscNum() override;
+  int clearRsc() override;
+  double getLoadFactor() override;
+  void printStats() override;
+
+  // 批量操作
+  int batchUpdateRsc(const std::map<int, std::string> &updated_map) override;
+  int batchGetRsc(std::map<int, std::string> &fetched_map) override;
+  int batchUpsertRsc(const std::map<int, std::string> &upserted_map) override;
+
+  // 清理共享内存
+  static int cleanup();
+  static int cleanup(const std::string &name);
+
+private:
+  explicit CuckooStatusRscManager(const std::string &shm_name);
+
+  // 桶定位：主桶由哈希决定，备用桶由当前桶与标签异或得到（互为备用）
+  uint32_t hash(int key) const;
+  static uint8_t tagOf(uint32_t hash_val);
+  static int primaryBucket(uint32_t hash_val);
+  static int altBucket(int bucket, uint8_t tag);
+  static int stripeOf(int bucket);
+
+  // 乐观读：在两个桶中查找键，value非空时复制值
+  bool optimisticFind(int key, std::string *value) const;
+
+  // 持锁读取：乐观读重试过多时使用，写者中途退出的条带在加锁时修复
+  bool lockedFind(int key, std::string *value) const;
+
+  // table_mutex是健壮锁：持锁进程退出后由下一个加锁者修复版本计数与条目数
+  void lockTable() const;
+  void unlockTable() const;
+  void recoverAfterOwnerDeath() const;
+
+  // 以下函数要求调用者持有table_mutex
+  bool findSlot(int key, int &bucket, int &slot) const;
+  int findFreeSlot(int bucket) const;
+  bool makeRoom(int b1, int b2, int &bucket, int &slot);
+  bool moveEntry(int from_bucket, int from_slot, int to_bucket, int to_slot);
+  void writeSlot(int bucket, int slot, int key, uint8_t tag,
+                 const std::string &value);
+  int insertLocked(int key, const std::string &value);
+  void beginWrite(int b1, int b2);
+  void endWrite(int b1, int b2);
+
+private:
+  std::string shm_name_;
+  CuckooSharedData *shared_data_;
+  int shm_fd_;
+  bool is_creator_;
+};
@@ -0,0 +1,239 @@
+#include "hot_key_tracker.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+const uint32_t SKETCH_ROW_SEEDS[HOT_KEY_SKETCH_DEPTH] = {
+    0x9e3779b9u, 0x85ebca6bu, 0xc2b2ae35u, 0x27d4eb2fu};
+
+const char *opName(HotKeyOp op) {
+  return op == HOT_KEY_READ ? "read" : "write";
+}
+
+bool hotterThan(const HotKeyStat &a, const HotKeyStat &b) {
+  return a.estimated_count > b.estimated_count;
+}
+
+} // namespace
+
+void HotKeyTracker::init(HotKeyTrackerData *data) {
+  data->enabled.store(false, std::memory_order_relaxed);
+  data->sample_rate.store(HOT_KEY_DEFAULT_SAMPLE_RATE,
+                          std::memory_order_relaxed);
+  data->lock.clear();
+  for (int op = 0; op < HOT_KEY_OP_COUNT; ++op) {
+    for (int w = 0; w < 2; ++w) {
+      HotKeyWindow &window = data->windows[op][w];
+      window.epoch.store(-1, std::memory_order_relaxed);
+      for (int row = 0; row < HOT_KEY_SKETCH_DEPTH; ++row) {
+        for (int col = 0; col < HOT_KEY_SKETCH_WIDTH; ++col) {
+          window.sketch[row][col].store(0, std::memory_order_relaxed);
+        }
+      }
+      window.top_size = 0;
+    }
+  }
+}
+
+void HotKeyTracker::setEnabled(bool enabled, int sample_rate) {
+  data_->sample_rate.store(sample_rate > 0 ? sample_rate : 1,
+                           std::memory_order_relaxed);
+  data_->enabled.store(enabled, std::memory_order_relaxed);
+}
+
+int64_t HotKeyTracker::currentEpoch() {
+  // steady_clock在Linux上对应CLOCK_MONOTONIC，所有进程一致
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::seconds>(now).count() /
+         HOT_KEY_WINDOW_SECONDS;
+}
+
+uint32_t HotKeyTracker::sketchIndex(int row, int key) {
+  uint32_t k = static_cast<uint32_t>(key) ^ SKETCH_ROW_SEEDS[row];
+  k ^= k >> 16;
+  k *= 0x85ebca6b;
+  k ^= k >> 13;
+  k *= 0xc2b2ae35;
+  k ^= k >> 16;
+  return k & (HOT_KEY_SKETCH_WIDTH - 1);
+}
+
+void HotKeyTracker::lock() const {
+  while (data_->lock.test_and_set(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+}
+
+void HotKeyTracker::unlock() const {
+  data_->lock.clear(std::memory_order_release);
+}
+
+HotKeyWindow &HotKeyTracker::windowFor(HotKeyOp op, int64_t epoch) {
+  HotKeyWindow &window = data_->windows[op][epoch & 1];
+  if (window.epoch.load(std::memory_order_acquire) == epoch) {
+    return window;
+  }
+
+  // 进入新的时间片：复用两个时间片之前的槽位
+  lock();
+  if (window.epoch.load(std::memory_order_relaxed) != epoch) {
+    for (int row = 0; row < HOT_KEY_SKETCH_DEPTH; ++row) {
+      for (int col = 0; col < HOT_KEY_SKETCH_WIDTH; ++col) {
+        window.sketch[row][col].store(0, std::memory_order_relaxed);
+      }
+    }
+    window.top_size = 0;
+    window.epoch.store(epoch, std::memory_order_release);
+  }
+  unlock();
+  return window;
+}
+
+uint32_t HotKeyTracker::estimate(const HotKeyWindow &window, int key) const {
+  uint32_t result = UINT32_MAX;
+  for (int row = 0; row < HOT_KEY_SKETCH_DEPTH; ++row) {
+    result = std::min(result, window.sketch[row][sketchIndex(row, key)].load(
+                                  std::memory_order_relaxed));
+  }
+  return result;
+}
+
+void HotKeyTracker::updateTop(HotKeyWindow &window, int key, uint32_t count) {
+  HotKeyCandidate *heap = window.top;
+  int size = window.top_size;
+  int pos = -1;
+
+  for (int i = 0; i < size; ++i) {
+    if (heap[i].key == key) {
+      heap[i].count = count;
+      pos = i;
+      break;
+    }
+  }
+
+  if (pos == -1) {
+    if (size < HOT_KEY_TOP_K) {
+      // 插入新元素并上浮
+      pos = size;
+      heap[pos].key = key;
+      heap[pos].count = count;
+      window.top_size = size + 1;
+      while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (heap[parent].count <= heap[pos].count) {
+          break;
+        }
+        std::swap(heap[parent], heap[pos]);
+        pos = parent;
+      }
+      return;
+    }
+    if (count <= heap[0].count) {
+      return;
+    }
+    // 替换堆顶（当前最冷的候选）
+    pos = 0;
+    heap[0].key = key;
+    heap[0].count = count;
+  }
+
+  // 计数只会增加，因此只需下沉
+  size = window.top_size;
+  for (;;) {
+    int smallest = pos;
+    int left = pos * 2 + 1;
+    int right = left + 1;
+    if (left < size && heap[left].count < heap[smallest].count) {
+      smallest = left;
+    }
+    if (right < size && heap[right].count < heap[smallest].count) {
+      smallest = right;
+    }
+    if (smallest == pos) {
+      break;
+    }
+    std::swap(heap[smallest], heap[pos]);
+    pos = smallest;
+  }
+}
+
+void HotKeyTracker::recordSampled(HotKeyOp op, int key, uint32_t weight) {
+  HotKeyWindow &window = windowFor(op, currentEpoch());
+
+  for (int row = 0; row < HOT_KEY_SKETCH_DEPTH; ++row) {
+    window.sketch[row][sketchIndex(row, key)].fetch_add(
+        weight, std::memory_order_relaxed);
+  }
+  uint32_t count = estimate(window, key);
+
+  lock();
+  updateTop(window, key, count);
+  unlock();
+}
+
+int HotKeyTracker::topKeys(HotKeyOp op, std::vector<HotKeyStat> &out,
+                           int limit) const {
+  out.clear();
+  int64_t epoch = currentEpoch();
+  const HotKeyWindow *live[2] = {nullptr, nullptr};
+  int live_count = 0;
+
+  // 只统计当前和上一个时间片
+  for (int w = 0; w < 2; ++w) {
+    const HotKeyWindow &window = data_->windows[op][w];
+    int64_t window_epoch = window.epoch.load(std::memory_order_acquire);
+    if (window_epoch == epoch || window_epoch == epoch - 1) {
+      live[live_count++] = &window;
+    }
+  }
+
+  std::vector<int> candidates;
+  lock();
+  for (int w = 0; w < live_count; ++w) {
+    for (int i = 0; i < live[w]->top_size; ++i) {
+      candidates.push_back(live[w]->top[i].key);
+    }
+  }
+  unlock();
+
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+
+  for (int key : candidates) {
+    HotKeyStat stat = {key, 0};
+    for (int w = 0; w < live_count; ++w) {
+      stat.estimated_count += estimate(*live[w], key);
+    }
+    out.push_back(stat);
+  }
+
+  std::sort(out.begin(), out.end(), hotterThan);
+  if (limit >= 0 && static_cast<int>(out.size()) > limit) {
+    out.resize(limit);
+  }
+  return static_cast<int>(out.size());
+}
+
+void HotKeyTracker::print(std::ostream &os) const {
+  os << "--- Hot Keys (window " << HOT_KEY_WINDOW_SECONDS << "-"
+     << 2 * HOT_KEY_WINDOW_SECONDS << "s, sample 1/"
+     << data_->sample_rate.load(std::memory_order_relaxed) << ") ---"
+     << std::endl;
+
+  std::vector<HotKeyStat> stats;
+  for (int op = 0; op < HOT_KEY_OP_COUNT; ++op) {
+    topKeys(static_cast<HotKeyOp>(op), stats, HOT_KEY_TOP_K);
+    os << "Hottest " << opName(static_cast<HotKeyOp>(op)) << " keys:";
+    if (stats.empty()) {
+      os << " (none)";
+    }
+    os << std::endl;
+    for (const HotKeyStat &stat : stats) {
+      os << "  " << stat.key << ": ~" << stat.estimated_count << std::endl;
+    }
+  }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// 热点键统计：count-min sketch + 小顶堆维护的top-K，按采样更新
+// 滑动窗口由当前时间片与上一个时间片组成，覆盖最近1~2个时间片
+enum HotKeyOp { HOT_KEY_READ = 0, HOT_KEY_WRITE = 1, HOT_KEY_OP_COUNT = 2 };
+
+const int HOT_KEY_SKETCH_DEPTH = 4;
+const int HOT_KEY_SKETCH_WIDTH = 1024; // 2的幂次
+const int HOT_KEY_TOP_K = 16;
+const int HOT_KEY_WINDOW_SECONDS = 10;
+const int HOT_KEY_DEFAULT_SAMPLE_RATE = 16; // 每N次操作采样1次
+
+struct HotKeyCandidate {
+  int key;
+  uint32_t count;
+};
+
+struct HotKeyWindow {
+  std::atomic<int64_t> epoch; // 该时间片的编号，-1表示未使用
+  std::atomic<uint32_t> sketch[HOT_KEY_SKETCH_DEPTH][HOT_KEY_SKETCH_WIDTH];
+  HotKeyCandidate top[HOT_KEY_TOP_K]; // 按count排列的小顶堆
+  int top_size;
+};
+
+struct HotKeyTrackerData {
+  std::atomic<bool> enabled;
+  std::atomic<int> sample_rate;
+  std::atomic_flag lock; // 保护top-K堆和时间片轮换
+  HotKeyWindow windows[HOT_KEY_OP_COUNT][2];
+};
+
+struct HotKeyStat {
+  int key;
+  uint32_t estimated_count; // 窗口内的估计操作次数（已按采样率放大）
+};
+
+// 共享内存中HotKeyTrackerData的无状态访问器
+class HotKeyTracker {
+public:
+  explicit HotKeyTracker(HotKeyTrackerData *data) : data_(data) {}
+
+  static void init(HotKeyTrackerData *data);
+
+  void setEnabled(bool enabled, int sample_rate);
+  bool enabled() const {
+    return data_->enabled.load(std::memory_order_relaxed);
+  }
+
+  // 热路径：未启用或未被采样时只有一次原子读和一次线程局部xorshift
+  // 采用随机采样而非固定间隔，避免与周期性访问模式混叠
+  void record(HotKeyOp op, int key) {
+    if (!enabled()) {
+      return;
+    }
+    static thread_local uint32_t state = 0x9e3779b9u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    uint32_t rate =
+        static_cast<uint32_t>(data_->sample_rate.load(std::memory_order_relaxed));
+    if (state % rate != 0) {
+      return;
+    }
+    recordSampled(op, key, rate);
+  }
+
+  // 按估计次数降序返回最热的键
+  int topKeys(HotKeyOp op, std::vector<HotKeyStat> &out, int limit) const;
+  void print(std::ostream &os) const;
+
+private:
+  void recordSampled(HotKeyOp op, int key, uint32_t weight);
+  HotKeyWindow &windowFor(HotKeyOp op, int64_t epoch);
+  uint32_t estimate(const HotKeyWindow &window, int key) const;
+  void updateTop(HotKeyWindow &window, int key, uint32_t count);
+  void lock() const;
+  void unlock() const;
+
+  static int64_t currentEpoch();
+  static uint32_t sketchIndex(int row, int key);
+
+private:
+  HotKeyTrackerData *data_;
+};
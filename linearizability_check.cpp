@@ -0,0 +1,427 @@
+/*
+ * 多进程线性一致性压力测试
+ * fork多个进程对同一张表执行随机操作，记录每个操作的调用/返回时间和结果，
+ * 全部结束后按键检查历史是否线性一致（Wing & Gong / Lowe算法），并输出吞吐量。
+ * 运行: ./linearizability_check [-p 进程数] [-n 每进程操作数] [-k 键数]
+ *                              [-e default|cuckoo] [-f]
+ * default引擎使用独立的"lincheck"键空间，cuckoo引擎使用独立的"lincheck"段，
+ * 均不触及生产数据；结束时清空键空间、删除布谷鸟段。
+ * -f为default引擎启用负查找过滤器，检验无锁未命中路径。
+ */
+
+#include "shared_memory_export.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+enum OpType {
+  OP_ADD,
+  OP_GET,
+  OP_UPDATE,
+  OP_UPSERT,
+  OP_REMOVE,
+  OP_CONTAINS,
+  OP_TYPE_COUNT
+};
+
+const char *const OP_NAMES[OP_TYPE_COUNT] = {"add",    "get",    "update",
+                                             "upsert", "remove", "contains"};
+
+// 放在fork前创建的匿名共享映射中，子进程直接写入
+struct OpRecord {
+  int type;
+  int key;
+  int arg;    // 写入的值编号
+  int result; // 返回码；get为读到的值编号（0表示不存在）；contains为0/1
+  int64_t invoke_ns;
+  int64_t response_ns;
+};
+
+struct ProcessSpan {
+  int64_t start_ns;
+  int64_t end_ns;
+  int completed;
+};
+
+int64_t nowNs() {
+  // steady_clock在Linux上对应CLOCK_MONOTONIC，各进程可比较
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::string encodeValue(int id) { return "v" + std::to_string(id); }
+
+int decodeValue(const std::string &value) {
+  return value.empty() ? 0 : std::atoi(value.c_str() + 1);
+}
+
+void runWorker(ISharedMemoryManager *manager, int proc, int ops, int keys,
+               OpRecord *records, ProcessSpan *span) {
+  std::mt19937 rng(static_cast<unsigned>(getpid()) * 2654435761u);
+  span->start_ns = nowNs();
+
+  for (int i = 0; i < ops; ++i) {
+    OpRecord &rec = records[i];
+    rec.type = static_cast<int>(rng() % OP_TYPE_COUNT);
+    rec.key = static_cast<int>(rng() % keys);
+    rec.arg = (proc + 1) * 1000000 + i + 1; // 全局唯一的值编号
+    std::string value = encodeValue(rec.arg);
+
+    rec.invoke_ns = nowNs();
+    switch (rec.type) {
+    case OP_ADD:
+      rec.result = manager->addRsc(rec.key, value);
+      break;
+    case OP_GET:
+      rec.result = decodeValue(manager->getRsc(rec.key));
+      break;
+    case OP_UPDATE:
+      rec.result = manager->updateRsc(rec.key, value);
+      break;
+    case OP_UPSERT:
+      rec.result = manager->upsertRsc(rec.key, value);
+      break;
+    case OP_REMOVE:
+      rec.result = manager->removeRsc(rec.key);
+      break;
+    default:
+      rec.result = manager->isContain(rec.key) ? 1 : 0;
+      break;
+    }
+    rec.response_ns = nowNs();
+    span->completed = i + 1;
+  }
+
+  span->end_ns = nowNs();
+}
+
+// 单个键的顺序规格：状态为当前值编号，0表示不存在
+bool applyModel(int state, const OpRecord &op, int &next) {
+  next = state;
+  switch (op.type) {
+  case OP_ADD:
+    if (state == 0) {
+      next = op.arg;
+      return op.result == OK;
+    }
+    return op.result == DUPLICATE_KEY;
+  case OP_GET:
+    return op.result == state;
+  case OP_UPDATE:
+    if (state != 0) {
+      next = op.arg;
+      return op.result == OK;
+    }
+    return op.result == NOT_FOUND;
+  case OP_UPSERT:
+    next = op.arg;
+    return op.result == OK;
+  case OP_REMOVE:
+    if (state != 0) {
+      next = 0;
+      return op.result == OK;
+    }
+    return op.result == NOT_FOUND;
+  default:
+    return op.result == (state != 0 ? 1 : 0);
+  }
+}
+
+struct Event {
+  bool is_call;
+  int op;      // 在该键历史中的操作序号
+  int64_t ts;
+  int match;   // 调用事件对应的返回事件下标
+  int prev;
+  int next;
+};
+
+bool eventBefore(const Event &a, const Event &b) {
+  // 时间相同时返回事件在前，避免把并不重叠的操作视为并发
+  if (a.ts != b.ts) {
+    return a.ts < b.ts;
+  }
+  return !a.is_call && b.is_call;
+}
+
+// Lowe的即时线性化算法：按时间顺序尝试线性化调用事件，遇到返回事件则回溯
+bool checkKeyHistory(const std::vector<OpRecord> &ops) {
+  const int n = static_cast<int>(ops.size());
+  if (n == 0) {
+    return true;
+  }
+
+  std::vector<Event> sorted;
+  sorted.reserve(2 * n);
+  for (int i = 0; i < n; ++i) {
+    Event call = {true, i, ops[i].invoke_ns, -1, -1, -1};
+    Event ret = {false, i, ops[i].response_ns, -1, -1, -1};
+    sorted.push_back(call);
+    sorted.push_back(ret);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(), eventBefore);
+
+  // 下标0为哨兵头结点
+  std::vector<Event> events(1);
+  events[0].is_call = false;
+  events.insert(events.end(), sorted.begin(), sorted.end());
+  std::vector<int> return_of(n, -1);
+  for (int i = 1; i < static_cast<int>(events.size()); ++i) {
+    events[i].prev = i - 1;
+    events[i].next = i + 1 < static_cast<int>(events.size()) ? i + 1 : -1;
+    if (!events[i].is_call) {
+      return_of[events[i].op] = i;
+    }
+  }
+  events[0].next = 1;
+  for (int i = 1; i < static_cast<int>(events.size()); ++i) {
+    if (events[i].is_call) {
+      events[i].match = return_of[events[i].op];
+    }
+  }
+
+  auto unlink = [&events](int i) {
+    events[events[i].prev].next = events[i].next;
+    if (events[i].next != -1) {
+      events[events[i].next].prev = events[i].prev;
+    }
+  };
+  auto relink = [&events](int i) {
+    events[events[i].prev].next = i;
+    if (events[i].next != -1) {
+      events[events[i].next].prev = i;
+    }
+  };
+
+  std::vector<uint64_t> linearized((n + 63) / 64, 0);
+  std::set<std::pair<std::vector<uint64_t>, int>> seen;
+  std::vector<std::pair<int, int>> stack; // (调用事件, 线性化前的状态)
+  int state = 0;
+  int entry = events[0].next;
+
+  while (events[0].next != -1) {
+    if (entry == -1) {
+      return false;
+    }
+    const Event &event = events[entry];
+    if (event.is_call) {
+      int next_state = 0;
+      bool ok = applyModel(state, ops[event.op], next_state);
+      if (ok) {
+        std::vector<uint64_t> candidate = linearized;
+        candidate[event.op / 64] |= 1ULL << (event.op % 64);
+        if (seen.insert(std::make_pair(candidate, next_state)).second) {
+          stack.push_back(std::make_pair(entry, state));
+          linearized.swap(candidate);
+          state = next_state;
+          unlink(entry);
+          unlink(event.match);
+          entry = events[0].next;
+          continue;
+        }
+      }
+      entry = event.next;
+    } else {
+      // 某个操作已经返回却无法线性化，回溯上一个选择
+      if (stack.empty()) {
+        return false;
+      }
+      int call = stack.back().first;
+      state = stack.back().second;
+      stack.pop_back();
+      int op = events[call].op;
+      linearized[op / 64] &= ~(1ULL << (op % 64));
+      relink(events[call].match);
+      relink(call);
+      entry = events[call].next;
+    }
+  }
+  return true;
+}
+
+void printHistory(const std::vector<OpRecord> &ops, size_t limit) {
+  int64_t base = ops.empty() ? 0 : ops.front().invoke_ns;
+  for (size_t i = 0; i < ops.size() && i < limit; ++i) {
+    const OpRecord &op = ops[i];
+    std::cout << "  [" << (op.invoke_ns - base) << ", "
+              << (op.response_ns - base) << "] " << OP_NAMES[op.type]
+              << "(arg=" << op.arg << ") -> " << op.result << std::endl;
+  }
+}
+
+bool invokedBefore(const OpRecord &a, const OpRecord &b) {
+  return a.invoke_ns < b.invoke_ns;
+}
+
+// 测试结束：清空专用键空间，或删除专用的布谷鸟段
+void releaseManager(const std::string &engine, ISharedMemoryManager *manager) {
+  if (engine == "cuckoo") {
+    cleanupNamedCuckooSharedMemory("lincheck");
+  } else {
+    manager->clearRsc();
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int processes = 8;
+  int ops_per_process = 2000;
+  int keys = 8;
+  std::string engine = "default";
+  bool negative_filter = false;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "p:n:k:e:f")) != -1) {
+    switch (opt) {
+    case 'p':
+      processes = std::atoi(optarg);
+      break;
+    case 'n':
+      ops_per_process = std::atoi(optarg);
+      break;
+    case 'k':
+      keys = std::atoi(optarg);
+      break;
+    case 'e':
+      engine = optarg;
+      break;
+    case 'f':
+      negative_filter = true;
+      break;
+    default:
+      std::cerr << "Usage: " << argv[0]
+                << " [-p processes] [-n ops] [-k keys] [-e default|cuckoo] [-f]"
+                << std::endl;
+      return 2;
+    }
+  }
+  if (processes <= 0 || ops_per_process <= 0 || keys <= 0) {
+    std::cerr << "Invalid arguments" << std::endl;
+    return 2;
+  }
+
+  ISharedMemoryManager *manager = nullptr;
+  if (engine == "cuckoo") {
+    manager = getNamedCuckooSharedMemoryManager("lincheck");
+  } else {
+    manager = getKeyspaceManager("lincheck");
+  }
+  if (manager == nullptr) {
+    std::cerr << "Failed to get shared memory manager" << std::endl;
+    return 1;
+  }
+  manager->clearRsc();
+  if (engine != "cuckoo") {
+    static_cast<OptimizedStatusRscManager *>(manager)->setNegativeFilter(
+        negative_filter);
+  }
+
+  std::cout << "=== Linearizability Stress Test (" << engine << ") ==="
+            << std::endl;
+  std::cout << processes << " processes x " << ops_per_process << " ops on "
+            << keys << " keys" << std::endl;
+
+  // 历史记录放在匿名共享映射中，子进程写入、父进程检查
+  size_t total_ops = static_cast<size_t>(processes) * ops_per_process;
+  size_t mapped_size =
+      total_ops * sizeof(OpRecord) + processes * sizeof(ProcessSpan);
+  void *mapped = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (mapped == MAP_FAILED) {
+    std::cerr << "mmap failed: " << strerror(errno) << std::endl;
+    releaseManager(engine, manager);
+    return 1;
+  }
+  OpRecord *records = static_cast<OpRecord *>(mapped);
+  ProcessSpan *spans = reinterpret_cast<ProcessSpan *>(records + total_ops);
+
+  std::vector<pid_t> children;
+  for (int p = 0; p < processes; ++p) {
+    pid_t pid = fork();
+    if (pid == -1) {
+      std::cerr << "fork failed: " << strerror(errno) << std::endl;
+      return 1;
+    }
+    if (pid == 0) {
+      runWorker(manager, p, ops_per_process, keys,
+                records + static_cast<size_t>(p) * ops_per_process, &spans[p]);
+      _exit(0);
+    }
+    children.push_back(pid);
+  }
+
+  bool all_exited = true;
+  for (pid_t pid : children) {
+    int status = 0;
+    if (waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0) {
+      all_exited = false;
+    }
+  }
+  if (!all_exited) {
+    std::cerr << "A worker process failed" << std::endl;
+    releaseManager(engine, manager);
+    return 1;
+  }
+
+  // 吞吐量
+  int64_t run_start = spans[0].start_ns;
+  int64_t run_end = spans[0].end_ns;
+  long long completed = 0;
+  for (int p = 0; p < processes; ++p) {
+    run_start = std::min(run_start, spans[p].start_ns);
+    run_end = std::max(run_end, spans[p].end_ns);
+    completed += spans[p].completed;
+  }
+  double seconds = static_cast<double>(run_end - run_start) / 1e9;
+  std::cout << "Completed " << completed << " ops in " << seconds * 1000
+            << " ms (" << static_cast<long long>(completed / seconds)
+            << " ops/s)" << std::endl;
+
+  // 线性一致性满足局部性：逐个键独立检查
+  std::vector<std::vector<OpRecord>> per_key(keys);
+  for (size_t i = 0; i < total_ops; ++i) {
+    per_key[records[i].key].push_back(records[i]);
+  }
+
+  int failed_keys = 0;
+  for (int k = 0; k < keys; ++k) {
+    std::sort(per_key[k].begin(), per_key[k].end(), invokedBefore);
+    if (!checkKeyHistory(per_key[k])) {
+      if (failed_keys == 0) {
+        std::cout << "✗ Key " << k << " history is NOT linearizable:"
+                  << std::endl;
+        printHistory(per_key[k], 50);
+      }
+      failed_keys++;
+    }
+  }
+
+  munmap(mapped, mapped_size);
+  releaseManager(engine, manager);
+
+  if (failed_keys > 0) {
+    std::cout << "✗ " << failed_keys << " of " << keys
+              << " keys failed the linearizability check" << std::endl;
+    return 1;
+  }
+  std::cout << "✓ All " << keys << " key histories are linearizable"
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * OpenMetrics导出守护进程
+ * 周期性地把所有键空间的统计写入文件（供node_exporter textfile等采集），
+ * 或在Unix域套接字上监听，每个连接返回一次最新的统计后关闭。
+ * 统计默认关闭，守护进程每个刷新周期为所有键空间（含新建的）开启统计。
+ * 运行: ./metrics_daemon [-f 输出文件] [-i 刷新间隔毫秒] [-s 套接字路径]
+ */
+
+#include "metrics_exporter.h"
+#include "optimized_status.h"
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+volatile sig_atomic_t g_stop = 0;
+
+void onSignal(int) { g_stop = 1; }
+
+void usage(const char *prog) {
+  std::cerr << "usage: " << prog
+            << " [-f output_file] [-i interval_ms] [-s unix_socket_path]"
+            << std::endl;
+}
+
+int openListenSocket(const std::string &path) {
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  if (path.length() >= sizeof(addr.sun_path)) {
+    std::cerr << "socket path too long: " << path << std::endl;
+    return -1;
+  }
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    std::cerr << "socket failed: " << strerror(errno) << std::endl;
+    return -1;
+  }
+  unlink(path.c_str());
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+      listen(fd, 16) != 0) {
+    std::cerr << "bind/listen failed: " << strerror(errno) << std::endl;
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+void serveOnce(int listen_fd) {
+  int client = accept(listen_fd, nullptr, nullptr);
+  if (client < 0) {
+    return;
+  }
+  std::string text = renderOpenMetrics();
+  size_t written = 0;
+  while (written < text.size()) {
+    ssize_t n = send(client, text.data() + written, text.size() - written,
+                     MSG_NOSIGNAL);
+    if (n <= 0) {
+      break;
+    }
+    written += static_cast<size_t>(n);
+  }
+  close(client);
+}
+
+// 统计默认关闭，开启只是一次原子写入，每个周期重复执行以覆盖新建的键空间
+void enableCollection() {
+  std::vector<std::string> names;
+  OptimizedStatusRscManager::listKeyspaces(names);
+  for (const std::string &name : names) {
+    OptimizedStatusRscManager *manager =
+        OptimizedStatusRscManager::getKeyspace(name);
+    if (manager != nullptr) {
+      manager->setMetricsEnabled(true);
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string file_path;
+  std::string socket_path;
+  int interval_ms = 1000;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "f:i:s:h")) != -1) {
+    switch (opt) {
+    case 'f':
+      file_path = optarg;
+      break;
+    case 'i':
+      interval_ms = std::atoi(optarg);
+      break;
+    case 's':
+      socket_path = optarg;
+      break;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if ((file_path.empty() && socket_path.empty()) || interval_ms <= 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  // 先映射共享内存，失败时尽早退出
+  OptimizedStatusRscManager::getInstance();
+
+  int listen_fd = -1;
+  if (!socket_path.empty()) {
+    listen_fd = openListenSocket(socket_path);
+    if (listen_fd < 0) {
+      return 1;
+    }
+  }
+
+  while (!g_stop) {
+    enableCollection();
+    if (!file_path.empty() && writeOpenMetricsFile(file_path) != OK) {
+      std::cerr << "failed to write " << file_path << std::endl;
+    }
+
+    // 等待到下一个刷新周期，期间处理套接字请求
+    pollfd pfd;
+    pfd.fd = listen_fd;
+    pfd.events = POLLIN;
+    int ready = poll(&pfd, listen_fd >= 0 ? 1 : 0, interval_ms);
+    if (ready > 0 && (pfd.revents & POLLIN)) {
+      serveOnce(listen_fd);
+    }
+  }
+
+  if (listen_fd >= 0) {
+    close(listen_fd);
+    unlink(socket_path.c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,158 @@
+#include "metrics_exporter.h"
+#include "optimized_status.h"
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+const char *const OP_STAT_NAMES[OP_STAT_COUNT] = {
+    "add", "get", "update", "upsert", "remove", "contains",
+    "batch_update", "batch_upsert", "batch_get", "clear"};
+
+void writeHeader(std::ostringstream &out, const char *name, const char *type,
+                 const char *help, const char *unit = nullptr) {
+    out << "# TYPE " << name << " " << type << "\n";
+    if (unit != nullptr) {
+        out << "# UNIT " << name << " " << unit << "\n";
+    }
+    out << "# HELP " << name << " " << help << "\n";
+}
+
+// 输出一个直方图：buckets[i]的上界为base * 2^i，最后一个桶对应+Inf
+void writeHistogram(std::ostringstream &out, const char *name,
+                    const std::string &labels, const uint64_t *buckets,
+                    int bucket_count, double base, double sum) {
+    uint64_t cumulative = 0;
+    double bound = base;
+    for (int i = 0; i < bucket_count - 1; ++i) {
+        cumulative += buckets[i];
+        out << name << "_bucket{" << labels << ",le=\"" << bound << "\"} "
+            << cumulative << "\n";
+        bound *= 2;
+    }
+    cumulative += buckets[bucket_count - 1];
+    out << name << "_bucket{" << labels << ",le=\"+Inf\"} " << cumulative << "\n";
+    out << name << "_count{" << labels << "} " << cumulative << "\n";
+    out << name << "_sum{" << labels << "} " << sum << "\n";
+}
+
+std::string keyspaceLabel(const KeyspaceMetrics &metrics) {
+    return "keyspace=\"" + metrics.keyspace + "\"";
+}
+
+} // namespace
+
+std::string renderOpenMetrics() {
+    std::vector<std::string> names;
+    OptimizedStatusRscManager::listKeyspaces(names);
+
+    std::vector<KeyspaceMetrics> all;
+    for (const std::string &name : names) {
+        OptimizedStatusRscManager *manager = OptimizedStatusRscManager::getKeyspace(name);
+        if (manager == nullptr) {
+            continue;
+        }
+        all.push_back(KeyspaceMetrics());
+        manager->collectMetrics(all.back());
+    }
+
+    std::ostringstream out;
+    out.precision(9);
+
+    writeHeader(out, "shm_table_entries", "gauge", "Occupied slots in the hash table.");
+    for (const KeyspaceMetrics &m : all) {
+        out << "shm_table_entries{" << keyspaceLabel(m) << "} " << m.current_count << "\n";
+    }
+    writeHeader(out, "shm_table_tombstones", "gauge", "Deleted slots awaiting rehash.");
+    for (const KeyspaceMetrics &m : all) {
+        out << "shm_table_tombstones{" << keyspaceLabel(m) << "} " << m.deleted_count << "\n";
+    }
+    writeHeader(out, "shm_table_capacity", "gauge", "Total slots in the hash table.");
+    for (const KeyspaceMetrics &m : all) {
+        out << "shm_table_capacity{" << keyspaceLabel(m) << "} " << m.capacity << "\n";
+    }
+    writeHeader(out, "shm_table_load_factor", "gauge",
+                "Occupied plus deleted slots divided by capacity.");
+    for (const KeyspaceMetrics &m : all) {
+        out << "shm_table_load_factor{" << keyspaceLabel(m) << "} "
+            << static_cast<double>(m.current_count + m.deleted_count) / m.capacity << "\n";
+    }
+
+    writeHeader(out, "shm_table_reseeds", "counter",
+                "Hash seed changes triggered by long probe chains.");
+    for (const KeyspaceMetrics &m : all) {
+        out << "shm_table_reseeds_total{" << keyspaceLabel(m) << "} "
+            << m.seed_generation << "\n";
+    }
+
+    writeHeader(out, "shm_probe_length", "histogram", "Slots probed per key lookup.");
+    for (const KeyspaceMetrics &m : all) {
+        writeHistogram(out, "shm_probe_length", keyspaceLabel(m), m.probe_buckets,
+                       PROBE_BUCKET_COUNT, 1, static_cast<double>(m.probe_sum));
+    }
+
+    writeHeader(out, "shm_operations", "counter", "Public operations executed.");
+    for (const KeyspaceMetrics &m : all) {
+        for (int op = 0; op < OP_STAT_COUNT; ++op) {
+            out << "shm_operations_total{" << keyspaceLabel(m) << ",op=\""
+                << OP_STAT_NAMES[op] << "\"} " << m.op_count[op] << "\n";
+        }
+    }
+
+    writeHeader(out, "shm_operation_latency_seconds", "histogram",
+                "Latency of public operations.", "seconds");
+    for (const KeyspaceMetrics &m : all) {
+        for (int op = 0; op < OP_STAT_COUNT; ++op) {
+            std::string labels = keyspaceLabel(m) + ",op=\"" + OP_STAT_NAMES[op] + "\"";
+            writeHistogram(out, "shm_operation_latency_seconds", labels,
+                           m.latency_buckets[op], LATENCY_BUCKET_COUNT,
+                           LATENCY_BASE_NS / 1e9, m.latency_ns_sum[op] / 1e9);
+        }
+    }
+
+    writeHeader(out, "shm_lock_acquisitions", "counter", "table_mutex acquisitions.");
+    for (const KeyspaceMetrics &m : all) {
+        out << "shm_lock_acquisitions_total{" << keyspaceLabel(m) << "} "
+            << m.lock_acquisitions << "\n";
+    }
+    writeHeader(out, "shm_lock_contended", "counter",
+                "table_mutex acquisitions that had to block.");
+    for (const KeyspaceMetrics &m : all) {
+        out << "shm_lock_contended_total{" << keyspaceLabel(m) << "} "
+            << m.lock_contended << "\n";
+    }
+    writeHeader(out, "shm_lock_wait_seconds", "counter",
+                "Time spent blocked on table_mutex.", "seconds");
+    for (const KeyspaceMetrics &m : all) {
+        out << "shm_lock_wait_seconds_total{" << keyspaceLabel(m) << "} "
+            << m.lock_wait_ns / 1e9 << "\n";
+    }
+
+    writeHeader(out, "shm_filter_negatives", "counter",
+                "Lookups answered as missing by the negative filter without locking.");
+    for (const KeyspaceMetrics &m : all) {
+        out << "shm_filter_negatives_total{" << keyspaceLabel(m) << "} "
+            << m.filter_negatives << "\n";
+    }
+
+    out << "# EOF\n";
+    return out.str();
+}
+
+int writeOpenMetricsFile(const std::string &path) {
+    std::string text = renderOpenMetrics();
+    std::string tmp_path = path + ".tmp";
+
+    FILE *file = fopen(tmp_path.c_str(), "w");
+    if (file == nullptr) {
+        return IO_ERR;
+    }
+    bool ok = fwrite(text.data(), 1, text.size(), file) == text.size();
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(tmp_path.c_str(), path.c_str()) != 0) {
+        remove(tmp_path.c_str());
+        return IO_ERR;
+    }
+    return OK;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+
+// OpenMetrics文本格式导出：覆盖所有键空间的占用、删除标记、探测长度分布、
+// 操作计数、延迟直方图和锁竞争计数。只读取原子计数器，不获取table_mutex
+std::string renderOpenMetrics();
+
+// 先写临时文件再rename，抓取方不会读到写了一半的内容
+// 成功返回OK，失败返回IO_ERR
+int writeOpenMetricsFile(const std::string &path);
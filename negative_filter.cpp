@@ -0,0 +1,53 @@
+#include "negative_filter.h"
+
+namespace {
+
+const uint64_t COUNTER_MAX = 0xf;
+
+} // namespace
+
+void NegativeFilter::init(NegativeFilterData *data, uint32_t seed) {
+    data->enabled.store(false, std::memory_order_relaxed);
+    data->seed = seed;
+    NegativeFilter(data).clear();
+}
+
+// 写者由table_mutex串行化，读-改-写无需CAS；
+// 以顺序一致的存储发布，保证写操作返回后其他进程的无锁查询能看到
+void NegativeFilter::add(int key) {
+    uint64_t h = mix(key);
+    NegativeFilterBlock &block = data_->blocks[blockOf(h)];
+    for (int i = 0; i < NEG_FILTER_HASHES; ++i) {
+        int counter = counterOf(h, i);
+        std::atomic<uint64_t> &word = block.words[counter >> 4];
+        int shift = (counter & 15) * 4;
+        uint64_t value = word.load(std::memory_order_relaxed);
+        if (((value >> shift) & COUNTER_MAX) != COUNTER_MAX) {
+            word.store(value + (1ULL << shift));
+        }
+    }
+}
+
+void NegativeFilter::remove(int key) {
+    uint64_t h = mix(key);
+    NegativeFilterBlock &block = data_->blocks[blockOf(h)];
+    for (int i = 0; i < NEG_FILTER_HASHES; ++i) {
+        int counter = counterOf(h, i);
+        std::atomic<uint64_t> &word = block.words[counter >> 4];
+        int shift = (counter & 15) * 4;
+        uint64_t value = word.load(std::memory_order_relaxed);
+        uint64_t count = (value >> shift) & COUNTER_MAX;
+        // 饱和的计数器无法得知真实值，保持不变
+        if (count != 0 && count != COUNTER_MAX) {
+            word.store(value - (1ULL << shift));
+        }
+    }
+}
+
+void NegativeFilter::clear() {
+    for (int b = 0; b < NEG_FILTER_BLOCK_COUNT; ++b) {
+        for (int w = 0; w < NEG_FILTER_WORDS_PER_BLOCK; ++w) {
+            data_->blocks[b].words[w].store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 分块计数布隆过滤器：每个键只映射到一个缓存行内的若干4位计数器，
+// 查询时只读一个缓存行；计数器支持删除，达到上限后不再变化（只可能增加误判）
+const int NEG_FILTER_BLOCK_COUNT = 256; // 2的幂次
+const int NEG_FILTER_WORDS_PER_BLOCK = 8;
+const int NEG_FILTER_HASHES = 4;
+
+struct alignas(64) NegativeFilterBlock {
+  std::atomic<uint64_t> words[NEG_FILTER_WORDS_PER_BLOCK]; // 每个字16个4位计数器
+};
+
+struct NegativeFilterData {
+  std::atomic<bool> enabled;
+  uint32_t seed; // 创建后不变，与表的哈希种子无关，重新选种时无需重建
+  NegativeFilterBlock blocks[NEG_FILTER_BLOCK_COUNT];
+};
+
+// 共享内存中NegativeFilterData的无状态访问器
+// 写操作（add/remove/clear）要求调用者持有table_mutex，读操作无锁
+class NegativeFilter {
+public:
+  explicit NegativeFilter(NegativeFilterData *data) : data_(data) {}
+
+  static void init(NegativeFilterData *data, uint32_t seed);
+
+  bool enabled() const {
+    return data_->enabled.load(std::memory_order_acquire);
+  }
+  void setEnabled(bool enabled) {
+    data_->enabled.store(enabled, std::memory_order_release);
+  }
+
+  // 返回false时键一定不存在
+  bool mayContain(int key) const {
+    uint64_t h = mix(key);
+    const NegativeFilterBlock &block = data_->blocks[blockOf(h)];
+    for (int i = 0; i < NEG_FILTER_HASHES; ++i) {
+      int counter = counterOf(h, i);
+      uint64_t word = block.words[counter >> 4].load();
+      if (((word >> ((counter & 15) * 4)) & 0xf) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void add(int key);
+  void remove(int key);
+  void clear();
+
+private:
+  uint64_t mix(int key) const {
+    uint64_t h = static_cast<uint32_t>(key) ^
+                 (static_cast<uint64_t>(data_->seed) << 32);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+  // 高位选块，低28位每7位选一个块内计数器
+  static int blockOf(uint64_t h) {
+    return static_cast<int>(h >> 40) & (NEG_FILTER_BLOCK_COUNT - 1);
+  }
+  static int counterOf(uint64_t h, int i) {
+    return static_cast<int>(h >> (i * 7)) & 0x7f;
+  }
+
+private:
+  NegativeFilterData *data_;
+};
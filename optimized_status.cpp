@@ -1,5 +1,12 @@
 #include "optimized_status.h"
+#include "cold_tier.h"
+#include "shm_common.h"
+#include "shm_trace.h"
+#include <algorithm>
 #include <cerrno>
+#include <csignal>
+#include <climits>
+#include <cstddef>
 #include <cstring>
 #include <fcntl.h>
 #include <iostream>
@@ -10,27 +17,165 @@
 #include <string>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <system_error>
 #include <unistd.h>
 #include <random>
+#include <sched.h>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+
+// 选择当前线程使用的计数器分片：Linux上按CPU划分，其他平台按线程ID散列
+static int counterShardIndex() {
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return cpu & (COUNTER_SHARDS - 1);
+    }
+#endif
+    static thread_local int shard = static_cast<int>(
+        std::hash<std::thread::id>()(std::this_thread::get_id()) & (COUNTER_SHARDS - 1));
+    return shard;
+}
+
+namespace {
+
+const char *const SHM_NAME = "/optimized_status_memory";
+
+// 批量读取因条目移动而重新开始的次数上限，超过后改为一次持锁完成
+const int MAX_BATCH_GET_RESTARTS = 3;
+
+std::atomic<bool> g_priority_inherit(false);
+std::atomic<int> g_max_batch_per_lock(0);
+
+uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 记录一次公开操作的调用次数和耗时
+class OpTimer {
+public:
+    OpTimer(OptimizedStatusRscManager *manager, OpStatType op, bool enabled)
+        : manager_(manager), op_(op), start_ns_(enabled ? nowNs() : 0) {}
+    ~OpTimer() {
+        if (start_ns_ != 0) {
+            manager_->recordOp(op_, nowNs() - start_ns_);
+        }
+    }
+
+private:
+    OptimizedStatusRscManager *manager_;
+    OpStatType op_;
+    uint64_t start_ns_;
+};
+
+// 批量操作的键哈希：一次向量化算出所有键的主/次哈希。
+// 持锁期间种子可能因重新选种或整表切换而变化，调用refresh()重算剩余部分
+class BatchHashes {
+public:
+    void clear() { keys_.clear(); }
+    void push(int key) { keys_.push_back(key); }
+    void assign(const std::map<int, std::string> &items) {
+        keys_.clear();
+        for (const auto &pair : items) {
+            keys_.push_back(pair.first);
+        }
+    }
+
+    // 从第from个键起用seed计算
+    void compute(size_t from, uint32_t seed) {
+        seed_ = seed;
+        hash1_.resize(keys_.size());
+        hash2_.resize(keys_.size());
+        if (from < keys_.size()) {
+            batchHash(keys_.data() + from, static_cast<int>(keys_.size() - from), seed,
+                      HASH_TABLE_SIZE - 1, hash1_.data() + from, hash2_.data() + from);
+        }
+    }
+    void refresh(size_t from, uint32_t seed) {
+        if (seed != seed_) {
+            compute(from, seed);
+        }
+    }
+
+    uint32_t hash1(size_t i) const { return hash1_[i]; }
+    uint32_t hash2(size_t i) const { return hash2_[i]; }
+
+private:
+    std::vector<int> keys_;
+    std::vector<uint32_t> hash1_;
+    std::vector<uint32_t> hash2_;
+    uint32_t seed_ = 0;
+};
+
+} // namespace
 
 OptimizedStatusRscManager &OptimizedStatusRscManager::getInstance() {
     static OptimizedStatusRscManager instance{};
     return instance;
 }
 
+OptimizedStatusRscManager *OptimizedStatusRscManager::getKeyspace(const std::string &name) {
+    OptimizedStatusRscManager &owner = getInstance();
+    if (name == DEFAULT_KEYSPACE_NAME) {
+        return &owner;
+    }
+    if (name.empty() || name.length() >= MAX_KEYSPACE_NAME_LEN) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> guard(owner.handles_mutex_);
+    auto it = owner.keyspace_handles_.find(name);
+    if (it != owner.keyspace_handles_.end()) {
+        return it->second.get();
+    }
+
+    KeyspaceData *keyspace = owner.findOrCreateKeyspace(name);
+    if (keyspace == nullptr) {
+        return nullptr;
+    }
+    std::unique_ptr<OptimizedStatusRscManager> handle(
+        new OptimizedStatusRscManager(owner.shared_data_, keyspace));
+    OptimizedStatusRscManager *result = handle.get();
+    owner.keyspace_handles_[name] = std::move(handle);
+    return result;
+}
+
+SharedArena OptimizedStatusRscManager::sharedArena() {
+    return SharedArena(&getInstance().shared_data_->arena);
+}
+
+int OptimizedStatusRscManager::listKeyspaces(std::vector<std::string> &names) {
+    OptimizedSharedData *shared_data = getInstance().shared_data_;
+    names.clear();
+
+    pthread_mutex_lock(&shared_data->init_mutex);
+    for (int i = 0; i < MAX_KEYSPACES; ++i) {
+        if (shared_data->keyspaces[i].in_use) {
+            names.push_back(shared_data->keyspaces[i].name);
+        }
+    }
+    pthread_mutex_unlock(&shared_data->init_mutex);
+    return static_cast<int>(names.size());
+}
+
 OptimizedStatusRscManager::OptimizedStatusRscManager()
-    : shared_data_(nullptr), shm_fd_(-1), is_creator_(false) {
+    : shared_data_(nullptr), ks_(nullptr), shm_fd_(-1), is_creator_(false),
+      cold_tier_(nullptr) {
 
     // 尝试打开已存在的共享内存
-    shm_fd_ = shm_open("/optimized_status_memory", O_RDWR, 0666);
+    shm_fd_ = shm_open(SHM_NAME, O_RDWR, 0666);
 
     if (shm_fd_ == -1) {
         // 共享内存不存在，创建新的
-        shm_fd_ = shm_open("/optimized_status_memory", O_CREAT | O_EXCL | O_RDWR, 0666);
+        shm_fd_ = shm_open(SHM_NAME, O_CREAT | O_EXCL | O_RDWR, 0666);
         if (shm_fd_ == -1) {
             if (errno == EEXIST) {
                 // 其他进程刚刚创建了，重新尝试打开
-                shm_fd_ = shm_open("/optimized_status_memory", O_RDWR, 0666);
+                shm_fd_ = shm_open(SHM_NAME, O_RDWR, 0666);
             }
             if (shm_fd_ == -1) {
                 throw std::runtime_error("shm_open failed: " + std::string(strerror(errno)));
@@ -41,87 +186,301 @@ OptimizedStatusRscManager::OptimizedStatusRscManager()
     }
 
     // 如果是创建者，设置大小
+    size_t segment_size = sizeof(OptimizedSharedData);
     if (is_creator_) {
-        if (ftruncate(shm_fd_, sizeof(OptimizedSharedData)) == -1) {
+        if (ftruncate(shm_fd_, segment_size) == -1) {
             close(shm_fd_);
-            shm_unlink("/optimized_status_memory");
+            shm_unlink(SHM_NAME);
             throw std::runtime_error("ftruncate failed: " + std::string(strerror(errno)));
         }
+    } else {
+        // 按实际大小映射：其他版本创建的段大小可能不同，校验头部后才能访问其余字段
+        struct stat st;
+        do {
+            if (fstat(shm_fd_, &st) == -1) {
+                close(shm_fd_);
+                throw std::runtime_error("fstat failed: " + std::string(strerror(errno)));
+            }
+            if (st.st_size == 0) {
+                usleep(1000);  // 创建者尚未设置大小
+            }
+        } while (st.st_size == 0);
+        segment_size = static_cast<size_t>(st.st_size);
     }
 
     // 映射共享内存
     shared_data_ = static_cast<OptimizedSharedData *>(
-        mmap(nullptr, sizeof(OptimizedSharedData), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0));
+        mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0));
 
     if (shared_data_ == MAP_FAILED) {
         close(shm_fd_);
         if (is_creator_) {
-            shm_unlink("/optimized_status_memory");
+            shm_unlink(SHM_NAME);
         }
         throw std::runtime_error("mmap failed: " + std::string(strerror(errno)));
     }
 
+    ks_ = &shared_data_->keyspaces[0];
+
     // 初始化共享数据
     if (is_creator_) {
-        // 初始化进程间互斥锁属性
-        pthread_mutexattr_t mutex_attr;
-        pthread_mutexattr_init(&mutex_attr);
-        pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
-        pthread_mutexattr_settype(&mutex_attr, PTHREAD_MUTEX_RECURSIVE);
-
-        // 初始化互斥锁
-        pthread_mutex_init(&shared_data_->table_mutex, &mutex_attr);
-        pthread_mutex_init(&shared_data_->init_mutex, &mutex_attr);
-
-        pthread_mutexattr_destroy(&mutex_attr);
-
-        // 初始化哈希表
-        shared_data_->current_count = 0;
-        shared_data_->deleted_count = 0;
-        
-        // 生成随机哈希种子
-        std::random_device rd;
-        shared_data_->hash_seed = rd();
+        initSegmentHeader(&shared_data_->header);
+        initSharedMutex(&shared_data_->init_mutex, g_priority_inherit.load());
 
-        // 初始化所有条目为空
-        for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
-            shared_data_->hash_table[i].state = EMPTY;
-            shared_data_->hash_table[i].key = 0;
-            shared_data_->hash_table[i].value[0] = '\0';
-            shared_data_->hash_table[i].hash_value = 0;
-        }
+        // 新段由ftruncate清零，其余键空间的in_use均为false
+        initKeyspace(ks_, DEFAULT_KEYSPACE_NAME);
+        SharedArena::init(&shared_data_->arena, g_priority_inherit.load());
+        OwnerRegistry::init(&shared_data_->owners);
 
         // 标记初始化完成
-        shared_data_->initialized = true;
+        shared_data_->header.initialized = 1;
     } else {
         // 等待初始化完成
-        while (!shared_data_->initialized) {
+        while (!shared_data_->header.initialized) {
             usleep(1000);  // 等待1ms
         }
+
+        std::string error = checkSegmentHeader(shared_data_->header, segment_size);
+        if (!error.empty()) {
+            munmap(shared_data_, segment_size);
+            shared_data_ = nullptr;
+            close(shm_fd_);
+            throw std::runtime_error("incompatible shared memory segment: " + error +
+                                     " (run shm_migrate or clean_shared)");
+        }
+    }
+}
+
+SegmentLayout OptimizedStatusRscManager::currentLayout() {
+    SegmentLayout layout;
+    memset(&layout, 0, sizeof(layout));
+    layout.hash_table_size = HASH_TABLE_SIZE;
+    layout.max_value_len = MAX_VALUE_LEN;
+    layout.max_keyspaces = MAX_KEYSPACES;
+    layout.keyspace_name_len = MAX_KEYSPACE_NAME_LEN;
+    layout.cold_tier_path_len = COLD_TIER_PATH_LEN;
+    layout.keyspaces_offset = offsetof(OptimizedSharedData, keyspaces);
+    layout.keyspace_stride = sizeof(KeyspaceData);
+    layout.ks_in_use_offset = offsetof(KeyspaceData, in_use);
+    layout.ks_name_offset = offsetof(KeyspaceData, name);
+    layout.ks_table_mutex_offset = offsetof(KeyspaceData, table_mutex);
+    layout.ks_hash_table_offset = offsetof(KeyspaceData, hash_tables);
+    layout.ks_active_table_offset = offsetof(KeyspaceData, active_table);
+    layout.ks_cold_tier_path_offset = offsetof(KeyspaceData, cold_tier_path);
+    layout.ks_cold_tier_capacity_offset = offsetof(KeyspaceData, cold_tier_capacity);
+    layout.entry_stride = sizeof(HashEntry);
+    layout.entry_key_offset = offsetof(HashEntry, key);
+    layout.entry_value_offset = offsetof(HashEntry, value);
+    layout.entry_state_offset = offsetof(HashEntry, state);
+    layout.ks_table_generation_offset = offsetof(KeyspaceData, table_generation);
+    layout.entry_generation_offset = offsetof(HashEntry, generation);
+    layout.ks_record_schema_offset = offsetof(KeyspaceData, record_schema);
+    layout.arena_offset = offsetof(OptimizedSharedData, arena);
+    layout.arena_size = SHARED_ARENA_SIZE;
+    layout.ks_history_offset = offsetof(KeyspaceData, history_offset);
+    layout.entry_owner_offset = offsetof(HashEntry, owner);
+    layout.ks_owner_tracking_offset = offsetof(KeyspaceData, owner_tracking);
+    layout.ks_metrics_enabled_offset = offsetof(KeyspaceData, metrics_enabled);
+    layout.ks_neg_filter_enabled_offset =
+        offsetof(KeyspaceData, neg_filter) + offsetof(NegativeFilterData, enabled);
+    layout.ks_hot_keys_enabled_offset =
+        offsetof(KeyspaceData, hot_keys) + offsetof(HotKeyTrackerData, enabled);
+    layout.ks_hot_keys_sample_rate_offset =
+        offsetof(KeyspaceData, hot_keys) + offsetof(HotKeyTrackerData, sample_rate);
+    return layout;
+}
+
+void OptimizedStatusRscManager::initSegmentHeader(SegmentHeader *header) {
+    header->magic = SEGMENT_MAGIC;
+    header->layout_version = SEGMENT_LAYOUT_VERSION;
+    header->segment_size = sizeof(OptimizedSharedData);
+    header->layout = currentLayout();
+}
+
+std::string OptimizedStatusRscManager::checkSegmentHeader(const SegmentHeader &header,
+                                                          size_t segment_size) {
+    if (header.magic != SEGMENT_MAGIC) {
+        return "missing segment header (created before layout versioning)";
     }
+    if (header.layout_version != SEGMENT_LAYOUT_VERSION) {
+        return "layout version " + std::to_string(header.layout_version) +
+               ", expected " + std::to_string(SEGMENT_LAYOUT_VERSION);
+    }
+    SegmentLayout expected = currentLayout();
+    if (header.segment_size != sizeof(OptimizedSharedData) ||
+        segment_size != sizeof(OptimizedSharedData) ||
+        memcmp(&header.layout, &expected, sizeof(expected)) != 0) {
+        return "geometry mismatch for layout version " +
+               std::to_string(header.layout_version);
+    }
+    return std::string();
 }
 
+OptimizedStatusRscManager::OptimizedStatusRscManager(OptimizedSharedData *shared_data,
+                                                     KeyspaceData *keyspace)
+    : shared_data_(shared_data), ks_(keyspace), shm_fd_(-1), is_creator_(false),
+      cold_tier_(nullptr) {}
+
 OptimizedStatusRscManager::~OptimizedStatusRscManager() {
+    delete cold_tier_.load();
+
+    // 只有默认实例持有映射
+    if (shm_fd_ == -1) {
+        return;
+    }
+    keyspace_handles_.clear();
     if (shared_data_ != nullptr && shared_data_ != MAP_FAILED) {
         munmap(shared_data_, sizeof(OptimizedSharedData));
     }
-    if (shm_fd_ != -1) {
-        close(shm_fd_);
+    close(shm_fd_);
+}
+
+void OptimizedStatusRscManager::initKeyspace(KeyspaceData *keyspace, const std::string &name) {
+    keyspace->priority_inherit = initSharedMutex(&keyspace->table_mutex, g_priority_inherit.load());
+    keyspace->layout_epoch = 0;
+
+    for (int i = 0; i < COUNTER_SHARDS; ++i) {
+        keyspace->counters[i].current_count.store(0, std::memory_order_relaxed);
+        keyspace->counters[i].deleted_count.store(0, std::memory_order_relaxed);
+    }
+
+    HotKeyTracker::init(&keyspace->hot_keys);
+
+    keyspace->cold_tier_enabled.store(false, std::memory_order_relaxed);
+    keyspace->cold_tier_capacity = 0;
+    keyspace->cold_tier_path[0] = '\0';
+    keyspace->clock_hand = 0;
+
+    keyspace->metrics_enabled.store(false, std::memory_order_relaxed);
+    RecordSchema::init(&keyspace->record_schema);
+    keyspace->history_offset = 0;
+    keyspace->owner_tracking.store(false, std::memory_order_relaxed);
+    for (int i = 0; i < MAX_OWNERS; ++i) {
+        keyspace->owner_heads[i] = -1;
+    }
+    keyspace->owner_check_countdown = OWNER_CHECK_INTERVAL;
+    keyspace->owner_reclaimed = 0;
+    for (int i = 0; i < COUNTER_SHARDS; ++i) {
+        OpStatsShard &stats = keyspace->op_stats[i];
+        for (int op = 0; op < OP_STAT_COUNT; ++op) {
+            stats.op_count[op].store(0, std::memory_order_relaxed);
+            stats.latency_ns_sum[op].store(0, std::memory_order_relaxed);
+            for (int b = 0; b < LATENCY_BUCKET_COUNT; ++b) {
+                stats.latency_buckets[op][b].store(0, std::memory_order_relaxed);
+            }
+        }
+        for (int b = 0; b < PROBE_BUCKET_COUNT; ++b) {
+            stats.probe_buckets[b].store(0, std::memory_order_relaxed);
+        }
+        stats.probe_sum.store(0, std::memory_order_relaxed);
+        stats.lock_acquisitions.store(0, std::memory_order_relaxed);
+        stats.lock_contended.store(0, std::memory_order_relaxed);
+        stats.lock_wait_ns.store(0, std::memory_order_relaxed);
+        stats.filter_negatives.store(0, std::memory_order_relaxed);
+    }
+
+    // 生成随机哈希种子，每个键空间独立
+    std::random_device rd;
+    keyspace->hash_seed = rd();
+    NegativeFilter::init(&keyspace->neg_filter, rd());
+    keyspace->seed_generation.store(0, std::memory_order_relaxed);
+    keyspace->long_probe_inserts = 0;
+    keyspace->inserts_since_reseed = 0;
+
+    strncpy(keyspace->name, name.c_str(), MAX_KEYSPACE_NAME_LEN - 1);
+    keyspace->name[MAX_KEYSPACE_NAME_LEN - 1] = '\0';
+
+    // 初始化两张表的所有条目为空
+    keyspace->active_table.store(0, std::memory_order_relaxed);
+    keyspace->refresh_owner.store(0, std::memory_order_relaxed);
+    for (int t = 0; t < 2; ++t) {
+        for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
+            HashEntry &entry = keyspace->hash_tables[t][i];
+            entry.state = EMPTY;
+            entry.key = 0;
+            entry.value[0] = '\0';
+            entry.hash_value = 0;
+            entry.referenced = 0;
+            entry.owner = 0;
+            entry.owner_prev = -1;
+            entry.owner_next = -1;
+            entry.generation = 0;
+        }
+        keyspace->table_generation[t] = 1;
+    }
+
+    // 最后发布，其他进程看到in_use时键空间已可用
+    std::atomic_thread_fence(std::memory_order_release);
+    keyspace->in_use = true;
+}
+
+KeyspaceData *OptimizedStatusRscManager::findOrCreateKeyspace(const std::string &name) {
+    pthread_mutex_lock(&shared_data_->init_mutex);
+
+    KeyspaceData *free_slot = nullptr;
+    for (int i = 0; i < MAX_KEYSPACES; ++i) {
+        KeyspaceData &keyspace = shared_data_->keyspaces[i];
+        if (!keyspace.in_use) {
+            if (free_slot == nullptr) {
+                free_slot = &keyspace;
+            }
+            continue;
+        }
+        if (name == keyspace.name) {
+            pthread_mutex_unlock(&shared_data_->init_mutex);
+            return &keyspace;
+        }
+    }
+
+    if (free_slot != nullptr) {
+        initKeyspace(free_slot, name);
+    }
+
+    pthread_mutex_unlock(&shared_data_->init_mutex);
+    return free_slot;
+}
+
+void OptimizedStatusRscManager::lockTable() {
+    SHM_TRACE1(lock_wait_start, keyspaceName());
+    if (!ks_->metrics_enabled.load(std::memory_order_relaxed)) {
+        pthread_mutex_lock(&ks_->table_mutex);
+        SHM_TRACE1(lock_wait_end, keyspaceName());
+        return;
+    }
+    OpStatsShard &stats = ks_->op_stats[counterShardIndex()];
+    if (pthread_mutex_trylock(&ks_->table_mutex) != 0) {
+        // 只有发生竞争时才计时
+        uint64_t start_ns = nowNs();
+        pthread_mutex_lock(&ks_->table_mutex);
+        stats.lock_contended.fetch_add(1, std::memory_order_relaxed);
+        stats.lock_wait_ns.fetch_add(nowNs() - start_ns, std::memory_order_relaxed);
     }
+    stats.lock_acquisitions.fetch_add(1, std::memory_order_relaxed);
+    SHM_TRACE1(lock_wait_end, keyspaceName());
 }
 
-int OptimizedStatusRscManager::findEntry(int key, uint32_t hash_val) {
-    uint32_t hash2_val = hash2(key);
+void OptimizedStatusRscManager::unlockTable() {
+    pthread_mutex_unlock(&ks_->table_mutex);
+    SHM_TRACE1(lock_release, keyspaceName());
+}
+
+int OptimizedStatusRscManager::findEntry(int key, uint32_t hash_val, uint32_t hash2_val) {
     int pos = hash_val;
+    uint32_t generation = tableGeneration();
     
     for (int step = 0; step < HASH_TABLE_SIZE; ++step) {
-        HashEntry &entry = shared_data_->hash_table[pos];
+        HashEntry &entry = table()[pos];
+        EntryState state = liveState(entry, generation);
         
-        if (entry.state == EMPTY) {
+        if (state == EMPTY) {
+            SHM_TRACE3(probe_done, key, step + 1, 0);
+            recordProbes(step + 1);
             return -1;  // 未找到
         }
         
-        if (entry.state == OCCUPIED && entry.key == key) {
+        if (state == OCCUPIED && entry.key == key) {
+            SHM_TRACE3(probe_done, key, step + 1, 1);
+            recordProbes(step + 1);
             return pos;  // 找到
         }
         
@@ -129,37 +488,87 @@ int OptimizedStatusRscManager::findEntry(int key, uint32_t hash_val) {
         pos = getNextProbe(pos, step + 1, hash2_val);
     }
     
+    SHM_TRACE3(probe_done, key, HASH_TABLE_SIZE, 0);
+    recordProbes(HASH_TABLE_SIZE);
     return -1;  // 表满，未找到
 }
 
-int OptimizedStatusRscManager::findEmptySlot(int key, uint32_t hash_val) {
-    uint32_t hash2_val = hash2(key);
+int OptimizedStatusRscManager::findEmptySlot(int key, uint32_t hash_val, uint32_t hash2_val,
+                                             int *probes) {
     int pos = hash_val;
     int first_deleted = -1;
+    uint32_t generation = tableGeneration();
     
     for (int step = 0; step < HASH_TABLE_SIZE; ++step) {
-        HashEntry &entry = shared_data_->hash_table[pos];
+        HashEntry &entry = table()[pos];
+        EntryState state = liveState(entry, generation);
         
-        if (entry.state == EMPTY) {
+        if (state == EMPTY) {
+            SHM_TRACE3(probe_done, key, step + 1, 0);
+            if (probes != nullptr) {
+                *probes = step + 1;
+            }
             return first_deleted != -1 ? first_deleted : pos;
         }
         
-        if (entry.state == DELETED && first_deleted == -1) {
+        if (state == DELETED && first_deleted == -1) {
             first_deleted = pos;
         }
         
-        if (entry.state == OCCUPIED && entry.key == key) {
+        if (state == OCCUPIED && entry.key == key) {
+            SHM_TRACE3(probe_done, key, step + 1, 1);
             return -1;  // 键已存在
         }
         
         pos = getNextProbe(pos, step + 1, hash2_val);
     }
     
+    SHM_TRACE3(probe_done, key, HASH_TABLE_SIZE, 0);
+    if (probes != nullptr) {
+        *probes = HASH_TABLE_SIZE;
+    }
     return first_deleted;  // 返回第一个删除的位置，如果没有则返回-1
 }
 
+int OptimizedStatusRscManager::currentCount() const {
+    int total = 0;
+    for (int i = 0; i < COUNTER_SHARDS; ++i) {
+        total += ks_->counters[i].current_count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+int OptimizedStatusRscManager::deletedCount() const {
+    int total = 0;
+    for (int i = 0; i < COUNTER_SHARDS; ++i) {
+        total += ks_->counters[i].deleted_count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void OptimizedStatusRscManager::adjustCounts(int current_delta, int deleted_delta) {
+    CounterShard &shard = ks_->counters[counterShardIndex()];
+    if (current_delta != 0) {
+        shard.current_count.fetch_add(current_delta, std::memory_order_relaxed);
+    }
+    if (deleted_delta != 0) {
+        shard.deleted_count.fetch_add(deleted_delta, std::memory_order_relaxed);
+    }
+}
+
+void OptimizedStatusRscManager::setCurrentCount(int count) {
+    // rscNum()无锁读取分片之和：差值一次加到一个分片上，读者不会看到中间值
+    adjustCounts(count - currentCount(), 0);
+}
+
+void OptimizedStatusRscManager::resetDeletedCounts() {
+    for (int i = 0; i < COUNTER_SHARDS; ++i) {
+        ks_->counters[i].deleted_count.store(0, std::memory_order_relaxed);
+    }
+}
+
 bool OptimizedStatusRscManager::needRehash() const {
-    return (shared_data_->current_count + shared_data_->deleted_count) > 
+    return (currentCount() + deletedCount()) > 
            static_cast<int>(HASH_TABLE_SIZE * MAX_LOAD_FACTOR);
 }
 
@@ -167,311 +576,1058 @@ int OptimizedStatusRscManager::rehashIfNeeded() {
     if (!needRehash()) {
         return OK;
     }
-    
+    return rehashLocked();
+}
+
+void OptimizedStatusRscManager::advanceGeneration(int table_index) {
+    uint32_t &generation = ks_->table_generation[table_index];
+    if (++generation == 0) {
+        // 回绕后旧条目的代数可能再次等于当前代数，此时真正清空一次（每2^32次清空发生一次）
+        HashEntry *entries = ks_->hash_tables[table_index];
+        for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
+            entries[i].state = EMPTY;
+            entries[i].generation = 0;
+        }
+        generation = 1;
+    }
+}
+
+int OptimizedStatusRscManager::rehashLocked() {
+    SHM_TRACE2(rehash_start, keyspaceName(), currentCount() + deletedCount());
+
     // 简单的清理策略：重新插入所有有效条目
-    // 在实际应用中，可能需要更复杂的rehash策略
-    std::map<int, std::string> temp_data;
+    // 暂存区按线程复用，首次之后持锁期间不再分配内存，缩短临界区
+    static thread_local std::vector<HashEntry> temp_data;
+    static thread_local BatchHashes hashes;
+    temp_data.clear();
+    temp_data.reserve(HASH_TABLE_SIZE);
+    hashes.clear();
     
     // 收集所有有效数据
+    uint32_t generation = tableGeneration();
     for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
-        if (shared_data_->hash_table[i].state == OCCUPIED) {
-            temp_data[shared_data_->hash_table[i].key] = shared_data_->hash_table[i].value;
+        if (liveState(table()[i], generation) == OCCUPIED) {
+            temp_data.push_back(table()[i]);
+            hashes.push(table()[i].key);
         }
     }
+    hashes.compute(0, ks_->hash_seed);
     
     // 清空表
-    for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
-        shared_data_->hash_table[i].state = EMPTY;
-    }
-    shared_data_->current_count = 0;
-    shared_data_->deleted_count = 0;
+    advanceGeneration(ks_->active_table.load(std::memory_order_relaxed));
+    generation = tableGeneration();
+    // 有效条目数不变，只清零删除计数
+    resetDeletedCounts();
+    ks_->layout_epoch++;
     
     // 重新插入数据
-    for (const auto &pair : temp_data) {
-        uint32_t hash_val = hash(pair.first);
-        int pos = findEmptySlot(pair.first, hash_val);
+    for (size_t i = 0; i < temp_data.size(); ++i) {
+        const HashEntry &saved = temp_data[i];
+        uint32_t hash_val = hashes.hash1(i);
+        int pos = findEmptySlot(saved.key, hash_val, hashes.hash2(i));
         if (pos == -1) {
+            SHM_TRACE2(table_full, keyspaceName(), saved.key);
+            adjustCounts(-static_cast<int>(temp_data.size() - i), 0);
+            rebuildOwnerLists();
             return NO_SPACE_ERR;
         }
         
-        HashEntry &entry = shared_data_->hash_table[pos];
-        entry.key = pair.first;
-        strncpy(entry.value, pair.second.c_str(), MAX_VALUE_LEN - 1);
-        entry.value[MAX_VALUE_LEN - 1] = '\0';
-        entry.state = OCCUPIED;
+        HashEntry &entry = table()[pos];
+        entry = saved;
         entry.hash_value = hash_val;
-        shared_data_->current_count++;
+        entry.generation = generation;
     }
+    rebuildOwnerLists();
     
+    SHM_TRACE2(rehash_end, keyspaceName(), currentCount());
     return OK;
 }
 
-int OptimizedStatusRscManager::removeRsc(int rsc_key) {
-    pthread_mutex_lock(&shared_data_->table_mutex);
-    
-    uint32_t hash_val = hash(rsc_key);
-    int pos = findEntry(rsc_key, hash_val);
-    
-    if (pos == -1) {
-        pthread_mutex_unlock(&shared_data_->table_mutex);
-        return NOT_FOUND;
-    }
-    
-    shared_data_->hash_table[pos].state = DELETED;
-    shared_data_->current_count--;
-    shared_data_->deleted_count++;
-    
-    pthread_mutex_unlock(&shared_data_->table_mutex);
-    return OK;
+void OptimizedStatusRscManager::setLockOptions(const LockOptions &options) {
+    g_priority_inherit.store(options.priority_inherit);
+    g_max_batch_per_lock.store(options.max_batch_per_lock);
 }
 
-int OptimizedStatusRscManager::batchUpdateRsc(const std::map<int, std::string> &updated_map) {
-    pthread_mutex_lock(&shared_data_->table_mutex);
-    
-    int success_count = 0;
-    for (const auto &pair : updated_map) {
-        if (pair.second.length() >= MAX_VALUE_LEN) {
-            continue;
-        }
-        
-        uint32_t hash_val = hash(pair.first);
-        int pos = findEntry(pair.first, hash_val);
-        
-        if (pos != -1) {
-            HashEntry &entry = shared_data_->hash_table[pos];
-            strncpy(entry.value, pair.second.c_str(), MAX_VALUE_LEN - 1);
-            entry.value[MAX_VALUE_LEN - 1] = '\0';
-            success_count++;
-        }
-    }
-    
-    pthread_mutex_unlock(&shared_data_->table_mutex);
-    return success_count;
+LockOptions OptimizedStatusRscManager::lockOptions() {
+    LockOptions options;
+    options.priority_inherit = g_priority_inherit.load();
+    options.max_batch_per_lock = g_max_batch_per_lock.load();
+    return options;
 }
 
-int OptimizedStatusRscManager::batchGetRsc(std::map<int, std::string> &fetched_map) {
-    pthread_mutex_lock(&shared_data_->table_mutex);
-    
-    fetched_map.clear();
-    for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
-        if (shared_data_->hash_table[i].state == OCCUPIED) {
-            fetched_map[shared_data_->hash_table[i].key] = shared_data_->hash_table[i].value;
-        }
+bool OptimizedStatusRscManager::yieldTableIfNeeded(int &work_in_section) {
+    int limit = g_max_batch_per_lock.load(std::memory_order_relaxed);
+    if (limit <= 0 || ++work_in_section < limit) {
+        return false;
     }
-    
-    pthread_mutex_unlock(&shared_data_->table_mutex);
-    return fetched_map.size();
+    // 优先级继承锁解锁时直接移交给最高优先级的等待者；普通锁让出CPU给等待者机会
+    unlockTable();
+    sched_yield();
+    lockTable();
+    work_in_section = 0;
+    return true;
 }
 
-int OptimizedStatusRscManager::cleanup() {
-    if (shm_unlink("/optimized_status_memory") == -1) {
-        if (errno != ENOENT) {
-            return -1;
-        }
+bool OptimizedStatusRscManager::shouldReseed(int insert_probes) {
+    ks_->inserts_since_reseed++;
+    if (insert_probes > RESEED_PROBE_THRESHOLD) {
+        ks_->long_probe_inserts++;
     }
-    return OK;
+    return ks_->long_probe_inserts >= RESEED_LONG_PROBE_LIMIT &&
+           ks_->inserts_since_reseed >= RESEED_MIN_INSERTS;
 }
 
-// 实现接口方法
-int OptimizedStatusRscManager::addRsc(int rsc_key, const std::string& rsc_value) {
-    if (rsc_value.empty()) return -1;
-    
-    if (rsc_value.length() >= MAX_VALUE_LEN) {
-        return NO_SPACE_ERR;
+int OptimizedStatusRscManager::reseedLocked() {
+    // 换用新种子后整表重新插入，其他进程在下一次加锁时自然使用新种子
+    std::random_device rd;
+    uint32_t seed = rd();
+    while (seed == ks_->hash_seed) {
+        seed = rd();
     }
+    ks_->hash_seed = seed;
+    ks_->long_probe_inserts = 0;
+    ks_->inserts_since_reseed = 0;
+    ks_->seed_generation.fetch_add(1, std::memory_order_release);
+    SHM_TRACE2(reseed, keyspaceName(), ks_->seed_generation.load(std::memory_order_relaxed));
+
+    return rehashLocked();
+}
+
+int OptimizedStatusRscManager::insertLocked(int key, const char *value, uint32_t hash_val,
+                                            uint32_t hash2_val) {
+    // 先把冷条目降级出去，再清理删除标记；正在插入的键不参与降级，
+    // 否则已存在的键会被移到冷数据层，随后在热表中插入重复的一份
+    demoteColdEntries(key);
 
-    pthread_mutex_lock(&shared_data_->table_mutex);
-    
     // 检查是否需要rehash
     if (rehashIfNeeded() != OK) {
-        pthread_mutex_unlock(&shared_data_->table_mutex);
         return NO_SPACE_ERR;
     }
     
-    uint32_t hash_val = hash(rsc_key);
-    int pos = findEmptySlot(rsc_key, hash_val);
+    int probes = 0;
+    int pos = findEmptySlot(key, hash_val, hash2_val, &probes);
     
     if (pos == -1) {
-        pthread_mutex_unlock(&shared_data_->table_mutex);
-        return shared_data_->current_count >= MAX_ENTRIES ? NO_SPACE_ERR : DUPLICATE_KEY;
+        if (currentCount() >= MAX_ENTRIES) {
+            SHM_TRACE2(table_full, keyspaceName(), key);
+            return NO_SPACE_ERR;
+        }
+        return DUPLICATE_KEY;
     }
     
-    HashEntry &entry = shared_data_->hash_table[pos];
-    if (entry.state == DELETED) {
-        shared_data_->deleted_count--;
-    }
+    HashEntry &entry = table()[pos];
+    uint32_t generation = tableGeneration();
+    adjustCounts(1, liveState(entry, generation) == DELETED ? -1 : 0);
     
-    entry.key = rsc_key;
-    strncpy(entry.value, rsc_value.c_str(), MAX_VALUE_LEN - 1);
-    entry.value[MAX_VALUE_LEN - 1] = '\0';
+    entry.key = key;
+    storeValue(entry.value, value);
     entry.state = OCCUPIED;
     entry.hash_value = hash_val;
-    shared_data_->current_count++;
-    
-    pthread_mutex_unlock(&shared_data_->table_mutex);
-    return OK;
+    entry.referenced = 1;
+    entry.owner = 0;
+    entry.generation = generation;
+    ownWriteLocked(pos);
+
+    NegativeFilter filter = negFilter();
+    if (filter.enabled()) {
+        filter.add(key);
+    }
 
+    // 探测链持续过长说明种子与键集分布不匹配，换种子以限制最坏查找长度
+    if (shouldReseed(probes)) {
+        reseedLocked();
+    }
+    return OK;
 }
 
-std::string OptimizedStatusRscManager::getRsc(int rsc_key) {
-    pthread_mutex_lock(&shared_data_->table_mutex);
-    
-    uint32_t hash_val = hash(rsc_key);
-    int pos = findEntry(rsc_key, hash_val);
-    
-    if (pos == -1) {
-        pthread_mutex_unlock(&shared_data_->table_mutex);
-        return "";
+ColdTier *OptimizedStatusRscManager::coldTier() {
+    if (!ks_->cold_tier_enabled.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    ColdTier *cold = cold_tier_.load(std::memory_order_acquire);
+    if (cold != nullptr) {
+        return cold;
     }
-    
-    std::string result(shared_data_->hash_table[pos].value);
-    pthread_mutex_unlock(&shared_data_->table_mutex);
-    return result;
 
+    // 其他进程启用了分层，本进程首次使用时打开同一个文件
+    lockTable();
+    cold = cold_tier_.load(std::memory_order_relaxed);
+    if (cold == nullptr) {
+        try {
+            cold = new ColdTier(ks_->cold_tier_path, ks_->cold_tier_capacity);
+            cold_tier_.store(cold, std::memory_order_release);
+        } catch (const std::exception &e) {
+            std::cerr << "Error opening cold tier: " << e.what() << std::endl;
+        }
+    }
+    unlockTable();
+    return cold;
 }
 
-int OptimizedStatusRscManager::updateRsc(int rsc_key, const std::string& rsc_value) {
-    if (rsc_value.empty()) return -1;
-    
-    if (rsc_value.length() >= MAX_VALUE_LEN) {
-        return NO_SPACE_ERR;
+int OptimizedStatusRscManager::demoteColdEntries(int keep_key) {
+    ColdTier *cold = coldTier();
+    if (cold == nullptr || currentCount() < HOT_TIER_HIGH_WATERMARK) {
+        return 0;
     }
 
-    pthread_mutex_lock(&shared_data_->table_mutex);
-    
-    uint32_t hash_val = hash(rsc_key);
-    int pos = findEntry(rsc_key, hash_val);
-    
-    if (pos == -1) {
-        pthread_mutex_unlock(&shared_data_->table_mutex);
-        return NOT_FOUND;
+    // CLOCK算法：访问位为1的条目获得第二次机会，为0的降级到冷数据层
+    // 降级以及冷数据层写入时的整理都会移动条目
+    ks_->layout_epoch++;
+    int demoted = 0;
+    uint32_t generation = tableGeneration();
+    for (int scanned = 0; scanned < 2 * HASH_TABLE_SIZE &&
+                          currentCount() > HOT_TIER_LOW_WATERMARK; ++scanned) {
+        HashEntry &entry = table()[ks_->clock_hand];
+        ks_->clock_hand = (ks_->clock_hand + 1) & (HASH_TABLE_SIZE - 1);
+
+        if (liveState(entry, generation) != OCCUPIED || entry.key == keep_key) {
+            continue;
+        }
+        if (entry.referenced) {
+            entry.referenced = 0;
+            continue;
+        }
+        if (cold->put(entry.key, entry.value) != OK) {
+            break;  // 冷数据层已满
+        }
+        entry.state = DELETED;
+        adjustCounts(-1, 1);
+        demoted++;
     }
-    
-    HashEntry &entry = shared_data_->hash_table[pos];
-    strncpy(entry.value, rsc_value.c_str(), MAX_VALUE_LEN - 1);
-    entry.value[MAX_VALUE_LEN - 1] = '\0';
-    
-    pthread_mutex_unlock(&shared_data_->table_mutex);
-    return OK;
+    return demoted;
+}
 
+void OptimizedStatusRscManager::promoteLocked(int key, const char *value, uint32_t hash_val,
+                                              ColdTier *cold) {
+    // 热表无法容纳时保留在冷数据层，值仍然保持最新
+    if (insertLocked(key, value, hash_val) == OK) {
+        cold->remove(key);
+        ks_->layout_epoch++;
+        // 过滤器按键计数，降级时未移除，提升时抵消insertLocked的重复计数
+        NegativeFilter filter = negFilter();
+        if (filter.enabled()) {
+            filter.remove(key);
+        }
+    } else {
+        cold->update(key, value);
+    }
 }
 
-int OptimizedStatusRscManager::upsertRsc(int rsc_key, const std::string& rsc_value) {
-    if (rsc_value.empty()) return -1;
-    
-    if (rsc_value.length() >= MAX_VALUE_LEN) {
-        return NO_SPACE_ERR;
+int OptimizedStatusRscManager::enableColdTier(const std::string &path, int capacity) {
+    if (path.empty() || path.length() >= COLD_TIER_PATH_LEN) {
+        return -1;
     }
 
-    pthread_mutex_lock(&shared_data_->table_mutex);
-    
-    uint32_t hash_val = hash(rsc_key);
-    int pos = findEntry(rsc_key, hash_val);
-    
-    if (pos != -1) {
-        // 更新现有条目
-        HashEntry &entry = shared_data_->hash_table[pos];
-        strncpy(entry.value, rsc_value.c_str(), MAX_VALUE_LEN - 1);
-        entry.value[MAX_VALUE_LEN - 1] = '\0';
-        pthread_mutex_unlock(&shared_data_->table_mutex);
-        return OK;
+    lockTable();
+
+    if (recordSchema().enabled() || ks_->owner_tracking.load(std::memory_order_relaxed)) {
+        unlockTable();
+        return -1;  // 冷数据层按字符串保存值，也不保存所有者
     }
-    
-    // 添加新条目
-    if (rehashIfNeeded() != OK) {
-        pthread_mutex_unlock(&shared_data_->table_mutex);
-        return NO_SPACE_ERR;
+    if (ks_->cold_tier_enabled.load(std::memory_order_relaxed)) {
+        bool same = path == ks_->cold_tier_path && capacity == ks_->cold_tier_capacity;
+        unlockTable();
+        return same ? OK : -1;
     }
-    
-    pos = findEmptySlot(rsc_key, hash_val);
-    if (pos == -1) {
-        pthread_mutex_unlock(&shared_data_->table_mutex);
-        return NO_SPACE_ERR;
+
+    ColdTier *cold = nullptr;
+    try {
+        cold = new ColdTier(path, capacity);
+    } catch (const std::exception &e) {
+        std::cerr << "Error enabling cold tier: " << e.what() << std::endl;
+        unlockTable();
+        return IO_ERR;
     }
-    
-    HashEntry &entry = shared_data_->hash_table[pos];
-    if (entry.state == DELETED) {
-        shared_data_->deleted_count--;
+    delete cold_tier_.exchange(cold);
+
+    // 冷数据层文件中已有的键须先加入过滤器，再对其他进程可见
+    NegativeFilter filter = negFilter();
+    if (filter.enabled()) {
+        std::map<int, std::string> cold_entries;
+        cold->collect(cold_entries);
+        for (const auto &pair : cold_entries) {
+            filter.add(pair.first);
+        }
     }
-    
-    entry.key = rsc_key;
-    strncpy(entry.value, rsc_value.c_str(), MAX_VALUE_LEN - 1);
-    entry.value[MAX_VALUE_LEN - 1] = '\0';
-    entry.state = OCCUPIED;
-    entry.hash_value = hash_val;
-    shared_data_->current_count++;
-    
-    pthread_mutex_unlock(&shared_data_->table_mutex);
-    return OK;
 
+    strncpy(ks_->cold_tier_path, path.c_str(), COLD_TIER_PATH_LEN - 1);
+    ks_->cold_tier_path[COLD_TIER_PATH_LEN - 1] = '\0';
+    ks_->cold_tier_capacity = capacity;
+    ks_->cold_tier_enabled.store(true, std::memory_order_release);
+
+    unlockTable();
+    return OK;
 }
 
-int OptimizedStatusRscManager::isContain(int rsc_key) {
-    pthread_mutex_lock(&shared_data_->table_mutex);
-    
-    uint32_t hash_val = hash(rsc_key);
+int OptimizedStatusRscManager::removeRsc(int rsc_key) {
+    OpTimer timer(this, OP_STAT_REMOVE, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_WRITE, rsc_key);
+
+    if (filteredMiss(rsc_key)) {
+        return NOT_FOUND;
+    }
+
+    lockTable();
+    int result = removeLocked(rsc_key, hash(rsc_key));
+    unlockTable();
+    return result;
+}
+
+int OptimizedStatusRscManager::removeLocked(int rsc_key, uint32_t hash_val) {
+    int pos = findEntry(rsc_key, hash_val);
+    NegativeFilter filter = negFilter();
+    
+    if (pos == -1) {
+        ColdTier *cold = coldTier();
+        int result = cold != nullptr ? cold->remove(rsc_key) : NOT_FOUND;
+        if (result == OK && filter.enabled()) {
+            filter.remove(rsc_key);
+        }
+        ValueHistoryData *history = historyData();
+        if (result == OK && history != nullptr) {
+            ValueHistory(history).drop(rsc_key);
+        }
+        return result;
+    }
+    
+    unlinkOwner(pos);
+    table()[pos].state = DELETED;
+    adjustCounts(-1, 1);
+    if (filter.enabled()) {
+        filter.remove(rsc_key);
+    }
+    ValueHistoryData *history = historyData();
+    if (history != nullptr) {
+        ValueHistory(history).drop(rsc_key);
+    }
+    return OK;
+}
+
+int OptimizedStatusRscManager::batchUpdateRsc(const std::map<int, std::string> &updated_map) {
+    OpTimer timer(this, OP_STAT_BATCH_UPDATE, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    if (recordSchema().enabled()) {
+        return -1;
+    }
+    static thread_local BatchHashes hashes;
+    hashes.assign(updated_map);
+    lockTable();
+    hashes.compute(0, ks_->hash_seed);
+    
+    int success_count = 0;
+    int work_in_section = 0;
+    size_t index = 0;
+    HotKeyTracker tracker = hotKeys();
+    ColdTier *cold = coldTier();
+    for (auto it = updated_map.begin(); it != updated_map.end(); ++it, ++index) {
+        const auto &pair = *it;
+        yieldTableIfNeeded(work_in_section);
+        // 让出锁期间其他进程可能重新选种或切换了整表，预先算好的哈希随之失效
+        hashes.refresh(index, ks_->hash_seed);
+        tracker.record(HOT_KEY_WRITE, pair.first);
+        if (pair.second.length() >= MAX_VALUE_LEN) {
+            continue;
+        }
+        
+        uint32_t hash_val = hashes.hash1(index);
+        int pos = findEntry(pair.first, hash_val, hashes.hash2(index));
+        
+        if (pos != -1) {
+            HashEntry &entry = table()[pos];
+            strncpy(entry.value, pair.second.c_str(), MAX_VALUE_LEN - 1);
+            entry.value[MAX_VALUE_LEN - 1] = '\0';
+            ownWriteLocked(pos);
+            recordHistory(pair.first, entry.value);
+            success_count++;
+        } else if (cold != nullptr && cold->update(pair.first, pair.second.c_str()) == OK) {
+            // 批量更新不视为访问，冷条目原地更新
+            recordHistory(pair.first, pair.second.c_str());
+            success_count++;
+        }
+    }
+    
+    unlockTable();
+    return success_count;
+}
+
+int OptimizedStatusRscManager::batchUpsertRsc(const std::map<int, std::string> &upserted_map) {
+    OpTimer timer(this, OP_STAT_BATCH_UPSERT, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    if (recordSchema().enabled()) {
+        return -1;
+    }
+    static thread_local BatchHashes hashes;
+    hashes.assign(upserted_map);
+    lockTable();
+    hashes.compute(0, ks_->hash_seed);
+
+    int success_count = 0;
+    int work_in_section = 0;
+    size_t index = 0;
+    HotKeyTracker tracker = hotKeys();
+    ColdTier *cold = coldTier();
+    for (auto it = upserted_map.begin(); it != upserted_map.end(); ++it, ++index) {
+        const auto &pair = *it;
+        yieldTableIfNeeded(work_in_section);
+        // 让出锁期间或上一次插入触发重新选种后，预先算好的哈希随之失效
+        hashes.refresh(index, ks_->hash_seed);
+        tracker.record(HOT_KEY_WRITE, pair.first);
+        if (pair.second.empty() || pair.second.length() >= MAX_VALUE_LEN) {
+            continue;
+        }
+
+        uint32_t hash_val = hashes.hash1(index);
+        uint32_t hash2_val = hashes.hash2(index);
+        int pos = findEntry(pair.first, hash_val, hash2_val);
+
+        if (pos != -1) {
+            HashEntry &entry = table()[pos];
+            strncpy(entry.value, pair.second.c_str(), MAX_VALUE_LEN - 1);
+            entry.value[MAX_VALUE_LEN - 1] = '\0';
+            entry.referenced = 1;
+            ownWriteLocked(pos);
+            recordHistory(pair.first, entry.value);
+            success_count++;
+        } else if (cold != nullptr && cold->get(pair.first, nullptr)) {
+            promoteLocked(pair.first, pair.second.c_str(), hash_val, cold);
+            recordHistory(pair.first, pair.second.c_str());
+            success_count++;
+        } else if (insertLocked(pair.first, pair.second.c_str(), hash_val, hash2_val) == OK) {
+            recordHistory(pair.first, pair.second.c_str());
+            success_count++;
+        }
+    }
+
+    unlockTable();
+    return success_count;
+}
+
+int OptimizedStatusRscManager::batchGetRsc(std::map<int, std::string> &fetched_map) {
+    OpTimer timer(this, OP_STAT_BATCH_GET, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    lockTable();
+    
+    // 分段读取：热表与冷数据层的槽位视为一个连续区间，每段之间释放锁；
+    // 期间若有条目移动则重新开始，多次失败后一次持锁读完
+    int limit = g_max_batch_per_lock.load(std::memory_order_relaxed);
+    for (int restarts = 0;; ++restarts) {
+        fetched_map.clear();
+        int chunk = limit > 0 && restarts < MAX_BATCH_GET_RESTARTS ? limit : INT_MAX;
+        uint32_t epoch = ks_->layout_epoch;
+        int slot = 0;
+        bool moved = false;
+        for (;;) {
+            ColdTier *cold = coldTier();
+            int total = HASH_TABLE_SIZE + (cold != nullptr ? cold->capacity() : 0);
+            int end = total - slot > chunk ? slot + chunk : total;
+            uint32_t generation = tableGeneration();
+            for (; slot < end && slot < HASH_TABLE_SIZE; ++slot) {
+                if (liveState(table()[slot], generation) == OCCUPIED) {
+                    fetched_map[table()[slot].key] = loadValue(table()[slot].value);
+                }
+            }
+            if (slot < end) {
+                cold->collect(fetched_map, slot - HASH_TABLE_SIZE, end - HASH_TABLE_SIZE);
+                slot = end;
+            }
+            if (slot >= total) {
+                break;
+            }
+
+            unlockTable();
+            sched_yield();
+            lockTable();
+            if (ks_->layout_epoch != epoch) {
+                moved = true;
+                break;
+            }
+        }
+        if (!moved) {
+            break;
+        }
+    }
+    
+    unlockTable();
+    return fetched_map.size();
+}
+
+int OptimizedStatusRscManager::cleanup() {
+    if (shm_unlink(SHM_NAME) == -1) {
+        if (errno != ENOENT) {
+            return -1;
+        }
+    }
+    return OK;
+}
+
+// 检查旧段的布局描述是否落在段内，防止按损坏的描述越界读取
+static bool layoutWithinSegment(const SegmentLayout &layout, size_t segment_size) {
+    if (layout.keyspace_stride == 0 || layout.entry_stride == 0 ||
+        layout.keyspaces_offset + layout.max_keyspaces * layout.keyspace_stride > segment_size) {
+        return false;
+    }
+    if (layout.ks_in_use_offset >= layout.keyspace_stride ||
+        layout.ks_name_offset + layout.keyspace_name_len > layout.keyspace_stride ||
+        layout.ks_table_mutex_offset + sizeof(pthread_mutex_t) > layout.keyspace_stride ||
+        layout.ks_hash_table_offset +
+                (layout.ks_active_table_offset != 0 ? 2 : 1) * layout.hash_table_size *
+                    layout.entry_stride > layout.keyspace_stride ||
+        layout.ks_active_table_offset + sizeof(int) > layout.keyspace_stride ||
+        layout.ks_cold_tier_path_offset + layout.cold_tier_path_len > layout.keyspace_stride ||
+        layout.ks_cold_tier_capacity_offset + sizeof(int) > layout.keyspace_stride) {
+        return false;
+    }
+    // 按旧段记录的大小检查，大小与当前不同的通用内存区由migrate()另行处理
+    if (layout.arena_offset != 0 &&
+        layout.arena_offset + offsetof(SharedArenaData, heap) + layout.arena_size > segment_size) {
+        return false;
+    }
+    if (layout.ks_record_schema_offset != 0 &&
+        layout.ks_record_schema_offset + sizeof(RecordSchemaData) > layout.keyspace_stride) {
+        return false;
+    }
+    if (layout.ks_history_offset != 0 &&
+        layout.ks_history_offset + sizeof(uint64_t) > layout.keyspace_stride) {
+        return false;
+    }
+    if (layout.entry_owner_offset != 0 &&
+        (layout.entry_owner_offset + sizeof(uint16_t) > layout.entry_stride ||
+         layout.ks_owner_tracking_offset + sizeof(bool) > layout.keyspace_stride)) {
+        return false;
+    }
+    if (layout.ks_metrics_enabled_offset != 0 &&
+        (layout.ks_metrics_enabled_offset + sizeof(bool) > layout.keyspace_stride ||
+         layout.ks_neg_filter_enabled_offset + sizeof(bool) > layout.keyspace_stride ||
+         layout.ks_hot_keys_enabled_offset + sizeof(bool) > layout.keyspace_stride ||
+         layout.ks_hot_keys_sample_rate_offset + sizeof(int) > layout.keyspace_stride)) {
+        return false;
+    }
+    if (layout.entry_generation_offset != 0 &&
+        (layout.entry_generation_offset + sizeof(uint32_t) > layout.entry_stride ||
+         layout.ks_table_generation_offset + 2 * sizeof(uint32_t) > layout.keyspace_stride)) {
+        return false;
+    }
+    return layout.entry_key_offset + sizeof(int) <= layout.entry_stride &&
+           layout.entry_value_offset + layout.max_value_len <= layout.entry_stride &&
+           layout.entry_state_offset + sizeof(int) <= layout.entry_stride;
+}
+
+int OptimizedStatusRscManager::migrate() {
+    int fd = shm_open(SHM_NAME, O_RDWR, 0666);
+    if (fd == -1) {
+        return errno == ENOENT ? 0 : IO_ERR;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(SegmentHeader)) {
+        close(fd);
+        return IO_ERR;
+    }
+    size_t old_size = static_cast<size_t>(st.st_size);
+    void *mapped = mmap(nullptr, old_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return IO_ERR;
+    }
+    char *old_base = static_cast<char *>(mapped);
+    const SegmentHeader *old_header = reinterpret_cast<const SegmentHeader *>(old_base);
+
+    while (!old_header->initialized) {
+        usleep(1000);
+    }
+
+    if (checkSegmentHeader(*old_header, old_size).empty()) {
+        munmap(mapped, old_size);
+        return 0;  // 已是当前布局
+    }
+    SegmentLayout layout = old_header->layout;
+    // 版本10之前的头部较短，所有者字段的位置是旧段的init_mutex而非填充
+    if (old_header->layout_version < 10) {
+        layout.entry_owner_offset = 0;
+        layout.ks_owner_tracking_offset = 0;
+    }
+    // 功能开关的偏移从版本12起才有
+    if (old_header->layout_version < 12) {
+        layout.ks_metrics_enabled_offset = 0;
+        layout.ks_neg_filter_enabled_offset = 0;
+        layout.ks_hot_keys_enabled_offset = 0;
+        layout.ks_hot_keys_sample_rate_offset = 0;
+    }
+    if (old_header->magic != SEGMENT_MAGIC || !layoutWithinSegment(layout, old_size)) {
+        std::cerr << "Cannot migrate shared memory segment: no usable layout header" << std::endl;
+        munmap(mapped, old_size);
+        return -1;
+    }
+
+    // 锁住旧段所有已启用的键空间，阻止旧版本进程在迁移期间写入
+    std::vector<char *> keyspaces;
+    for (uint32_t i = 0; i < layout.max_keyspaces; ++i) {
+        char *ks_base = old_base + layout.keyspaces_offset + i * layout.keyspace_stride;
+        if (*reinterpret_cast<volatile bool *>(ks_base + layout.ks_in_use_offset)) {
+            pthread_mutex_lock(reinterpret_cast<pthread_mutex_t *>(ks_base + layout.ks_table_mutex_offset));
+            keyspaces.push_back(ks_base);
+        }
+    }
+    SharedArenaData *old_arena = nullptr;
+    if (layout.arena_offset != 0) {
+        old_arena = reinterpret_cast<SharedArenaData *>(old_base + layout.arena_offset);
+        pthread_mutex_lock(&old_arena->mutex);
+        // 大小不同的通用内存区无法原样复制，其中的具名对象与OffsetPtr数据会丢失：
+        // 已有分配时在修改任何内容之前拒绝迁移
+        if (layout.arena_size != SHARED_ARENA_SIZE && old_arena->used_bytes != 0) {
+            std::cerr << "Cannot migrate shared memory segment: shared arena size "
+                      << layout.arena_size << " differs from " << SHARED_ARENA_SIZE
+                      << " and holds " << old_arena->used_bytes << " allocated bytes" << std::endl;
+            pthread_mutex_unlock(&old_arena->mutex);
+            for (char *ks_base : keyspaces) {
+                pthread_mutex_unlock(reinterpret_cast<pthread_mutex_t *>(ks_base + layout.ks_table_mutex_offset));
+            }
+            munmap(mapped, old_size);
+            return -1;
+        }
+    }
+
+    // 摘除旧段名称：随后由本进程按当前布局重新创建，已映射旧段的进程不受影响
+    shm_unlink(SHM_NAME);
+
+    int migrated = 0;
+    int failed_items = 0;     // 未能写入的条目
+    int failed_keyspaces = 0; // 无法重建或恢复设置的键空间
+    int disowned = 0;
+    // 取值历史位于通用内存区，复制通用内存区之后再挂回各键空间，迁移写入不追加历史
+    std::vector<std::pair<OptimizedStatusRscManager *, uint64_t>> histories;
+    try {
+        for (char *ks_base : keyspaces) {
+            std::string name(ks_base + layout.ks_name_offset,
+                             strnlen(ks_base + layout.ks_name_offset, layout.keyspace_name_len));
+            OptimizedStatusRscManager *target = getKeyspace(name);
+            if (target == nullptr) {
+                std::cerr << "Cannot recreate keyspace " << name << std::endl;
+                failed_keyspaces++;
+                continue;
+            }
+
+            // 先恢复冷数据层，冷层文件中的条目无需搬迁
+            const char *cold_path = ks_base + layout.ks_cold_tier_path_offset;
+            size_t cold_path_len = strnlen(cold_path, layout.cold_tier_path_len);
+            if (layout.cold_tier_path_len != 0 && cold_path_len > 0 &&
+                cold_path_len < layout.cold_tier_path_len) {
+                int capacity;
+                memcpy(&capacity, ks_base + layout.ks_cold_tier_capacity_offset, sizeof(capacity));
+                if (target->enableColdTier(std::string(cold_path, cold_path_len), capacity) != OK) {
+                    std::cerr << "Cannot reopen cold tier of keyspace " << name << std::endl;
+                    failed_keyspaces++;
+                }
+            }
+
+            // 定长记录键空间先恢复布局，记录按原始字节写入
+            bool records = false;
+            if (layout.ks_record_schema_offset != 0) {
+                const RecordSchemaData *schema = reinterpret_cast<const RecordSchemaData *>(
+                    ks_base + layout.ks_record_schema_offset);
+                if (schema->field_count.load() > 0) {
+                    target->lockTable();
+                    target->recordSchema().assign(*schema);
+                    target->unlockTable();
+                    records = true;
+                }
+            }
+
+            if (layout.ks_history_offset != 0) {
+                uint64_t history_offset;
+                memcpy(&history_offset, ks_base + layout.ks_history_offset, sizeof(history_offset));
+                if (history_offset != 0) {
+                    histories.push_back(std::make_pair(target, history_offset));
+                }
+            }
+
+            // 双缓冲的段只迁移活动表
+            uint64_t table_offset = layout.ks_hash_table_offset;
+            int active = 0;
+            if (layout.ks_active_table_offset != 0) {
+                memcpy(&active, ks_base + layout.ks_active_table_offset, sizeof(active));
+                active = active == 1 ? 1 : 0;
+                table_offset += active * layout.hash_table_size * layout.entry_stride;
+            }
+            // 带代数戳的段中，代数落后的条目已被清空
+            uint32_t table_generation = 0;
+            if (layout.entry_generation_offset != 0) {
+                memcpy(&table_generation,
+                       ks_base + layout.ks_table_generation_offset + active * sizeof(uint32_t),
+                       sizeof(table_generation));
+            }
+            for (uint32_t j = 0; j < layout.hash_table_size; ++j) {
+                const char *entry = ks_base + table_offset + j * layout.entry_stride;
+                int state;
+                int key;
+                memcpy(&state, entry + layout.entry_state_offset, sizeof(state));
+                if (state != OCCUPIED) {
+                    continue;
+                }
+                if (layout.entry_generation_offset != 0) {
+                    uint32_t generation;
+                    memcpy(&generation, entry + layout.entry_generation_offset, sizeof(generation));
+                    if (generation != table_generation) {
+                        continue;
+                    }
+                }
+                // 登记表不随段迁移，有主条目按无主写入，写入进程退出后不再自动回收
+                if (layout.entry_owner_offset != 0) {
+                    uint16_t owner;
+                    memcpy(&owner, entry + layout.entry_owner_offset, sizeof(owner));
+                    if (owner != 0) {
+                        disowned++;
+                    }
+                }
+                memcpy(&key, entry + layout.entry_key_offset, sizeof(key));
+                const char *value = entry + layout.entry_value_offset;
+                int result;
+                if (records) {
+                    result = target->putRecord(key, value);
+                } else {
+                    result = target->upsertRsc(key, std::string(value, strnlen(value, layout.max_value_len)));
+                }
+                if (result == OK) {
+                    migrated++;
+                } else {
+                    failed_items++;
+                }
+            }
+
+            // 条目写完后再开启所有者标记，迁移写入的条目保持无主
+            if (layout.entry_owner_offset != 0 &&
+                *reinterpret_cast<const bool *>(ks_base + layout.ks_owner_tracking_offset) &&
+                target->enableOwnerTracking() != OK) {
+                std::cerr << "Cannot re-enable owner tracking of keyspace " << name << std::endl;
+                failed_keyspaces++;
+            }
+
+            // 功能开关；负查找过滤器在条目写完后按内容重建
+            if (layout.ks_metrics_enabled_offset != 0) {
+                bool metrics;
+                bool filter;
+                bool hot_keys;
+                int sample_rate;
+                memcpy(&metrics, ks_base + layout.ks_metrics_enabled_offset, sizeof(metrics));
+                memcpy(&filter, ks_base + layout.ks_neg_filter_enabled_offset, sizeof(filter));
+                memcpy(&hot_keys, ks_base + layout.ks_hot_keys_enabled_offset, sizeof(hot_keys));
+                memcpy(&sample_rate, ks_base + layout.ks_hot_keys_sample_rate_offset, sizeof(sample_rate));
+                target->setMetricsEnabled(metrics);
+                target->setHotKeyTracking(hot_keys, sample_rate > 0 ? sample_rate : HOT_KEY_DEFAULT_SAMPLE_RATE);
+                if (target->setNegativeFilter(filter) != OK) {
+                    std::cerr << "Cannot restore negative filter of keyspace " << name << std::endl;
+                    failed_keyspaces++;
+                }
+            }
+        }
+
+        // 通用内存区按原样复制（互斥锁除外），其中的偏移与OffsetPtr保持有效
+        if (old_arena != nullptr) {
+            // 大小不同时旧区域没有分配（见上文的检查），无需复制
+            if (layout.arena_size == SHARED_ARENA_SIZE) {
+                SharedArenaData &arena = getInstance().shared_data_->arena;
+                size_t begin = offsetof(SharedArenaData, free_head);
+                pthread_mutex_lock(&arena.mutex);
+                memcpy(reinterpret_cast<char *>(&arena) + begin,
+                       reinterpret_cast<const char *>(old_arena) + begin,
+                       sizeof(SharedArenaData) - begin);
+                pthread_mutex_unlock(&arena.mutex);
+                for (const auto &history : histories) {
+                    history.first->lockTable();
+                    history.first->ks_->history_offset = history.second;
+                    history.first->unlockTable();
+                }
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error migrating shared memory: " << e.what() << std::endl;
+        failed_keyspaces++;
+    }
+
+    for (char *ks_base : keyspaces) {
+        pthread_mutex_unlock(reinterpret_cast<pthread_mutex_t *>(ks_base + layout.ks_table_mutex_offset));
+    }
+    if (old_arena != nullptr) {
+        pthread_mutex_unlock(&old_arena->mutex);
+    }
+    munmap(mapped, old_size);
+
+    if (disowned > 0) {
+        std::cerr << "Shared memory migration cleared the owner of " << disowned
+                  << " item(s); they are no longer reclaimed when their writer exits" << std::endl;
+    }
+    if (failed_keyspaces > 0) {
+        std::cerr << "Shared memory migration could not restore " << failed_keyspaces
+                  << " keyspace(s) or keyspace setting(s)" << std::endl;
+    }
+    if (failed_items > 0) {
+        std::cerr << "Shared memory migration dropped " << failed_items << " item(s), migrated "
+                  << migrated << std::endl;
+    }
+    if (failed_keyspaces > 0) {
+        return IO_ERR;
+    }
+    return failed_items > 0 ? NO_SPACE_ERR : migrated;
+}
+
+// 实现接口方法
+int OptimizedStatusRscManager::addRsc(int rsc_key, const std::string& rsc_value) {
+    OpTimer timer(this, OP_STAT_ADD, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_WRITE, rsc_key);
+
+    if (rsc_value.empty() || recordSchema().enabled()) return -1;
+    
+    if (rsc_value.length() >= MAX_VALUE_LEN) {
+        return NO_SPACE_ERR;
+    }
+
+    lockTable();
+    int result = addLocked(rsc_key, rsc_value.c_str(), hash(rsc_key));
+    unlockTable();
+    return result;
+
+}
+
+int OptimizedStatusRscManager::addLocked(int rsc_key, const char *rsc_value, uint32_t hash_val) {
+    ColdTier *cold = coldTier();
+    if (cold != nullptr && cold->get(rsc_key, nullptr)) {
+        return DUPLICATE_KEY;
+    }
+
+    int result = insertLocked(rsc_key, rsc_value, hash_val);
+    if (result == OK) {
+        recordHistory(rsc_key, rsc_value);
+    }
+    return result;
+}
+
+std::string OptimizedStatusRscManager::getRsc(int rsc_key) {
+    OpTimer timer(this, OP_STAT_GET, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_READ, rsc_key);
+
+    if (filteredMiss(rsc_key)) {
+        return std::string();
+    }
+
+    char value[MAX_VALUE_LEN];
+    lockTable();
+    int len = getLocked(rsc_key, hash(rsc_key), value);
+    unlockTable();
+    return len < 0 ? std::string() : std::string(value, len);
+
+}
+
+int OptimizedStatusRscManager::getLocked(int rsc_key, uint32_t hash_val, char *value) {
+    int pos = findEntry(rsc_key, hash_val);
+    
+    if (pos == -1) {
+        // 热表未命中时查找冷数据层，命中则提升回热表
+        std::string cold_value;
+        ColdTier *cold = coldTier();
+        if (cold == nullptr || !cold->get(rsc_key, &cold_value)) {
+            return NOT_FOUND;
+        }
+        promoteLocked(rsc_key, cold_value.c_str(), hash_val, cold);
+        memcpy(value, cold_value.data(), cold_value.size());
+        return static_cast<int>(cold_value.size());
+    }
+    
+    HashEntry &entry = table()[pos];
+    if (!entry.referenced) {
+        entry.referenced = 1;
+    }
+    int record_size = recordSchema().recordSize();
+    int len = record_size > 0 ? record_size : static_cast<int>(strnlen(entry.value, MAX_VALUE_LEN));
+    memcpy(value, entry.value, len);
+    return len;
+}
+
+int OptimizedStatusRscManager::updateRsc(int rsc_key, const std::string& rsc_value) {
+    OpTimer timer(this, OP_STAT_UPDATE, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_WRITE, rsc_key);
+
+    if (rsc_value.empty() || recordSchema().enabled()) return -1;
+    
+    if (rsc_value.length() >= MAX_VALUE_LEN) {
+        return NO_SPACE_ERR;
+    }
+
+    if (filteredMiss(rsc_key)) {
+        return NOT_FOUND;
+    }
+
+    lockTable();
+    int result = updateLocked(rsc_key, rsc_value.c_str(), hash(rsc_key));
+    unlockTable();
+    return result;
+
+}
+
+int OptimizedStatusRscManager::updateLocked(int rsc_key, const char *rsc_value, uint32_t hash_val) {
+    int pos = findEntry(rsc_key, hash_val);
+    
+    if (pos == -1) {
+        ColdTier *cold = coldTier();
+        if (cold == nullptr || !cold->get(rsc_key, nullptr)) {
+            return NOT_FOUND;
+        }
+        promoteLocked(rsc_key, rsc_value, hash_val, cold);
+        recordHistory(rsc_key, rsc_value);
+        return OK;
+    }
+    
+    HashEntry &entry = table()[pos];
+    strncpy(entry.value, rsc_value, MAX_VALUE_LEN - 1);
+    entry.value[MAX_VALUE_LEN - 1] = '\0';
+    entry.referenced = 1;
+    ownWriteLocked(pos);
+    recordHistory(rsc_key, entry.value);
+    return OK;
+}
+
+int OptimizedStatusRscManager::upsertRsc(int rsc_key, const std::string& rsc_value) {
+    OpTimer timer(this, OP_STAT_UPSERT, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_WRITE, rsc_key);
+
+    if (rsc_value.empty() || recordSchema().enabled()) return -1;
+    
+    if (rsc_value.length() >= MAX_VALUE_LEN) {
+        return NO_SPACE_ERR;
+    }
+
+    lockTable();
+    int result = upsertLocked(rsc_key, rsc_value.c_str(), hash(rsc_key));
+    unlockTable();
+    return result;
+
+}
+
+int OptimizedStatusRscManager::upsertLocked(int rsc_key, const char *rsc_value, uint32_t hash_val) {
     int pos = findEntry(rsc_key, hash_val);
     
-    pthread_mutex_unlock(&shared_data_->table_mutex);
-    return pos != -1;
+    if (pos != -1) {
+        // 更新现有条目
+        HashEntry &entry = table()[pos];
+        strncpy(entry.value, rsc_value, MAX_VALUE_LEN - 1);
+        entry.value[MAX_VALUE_LEN - 1] = '\0';
+        entry.referenced = 1;
+        ownWriteLocked(pos);
+        recordHistory(rsc_key, entry.value);
+        return OK;
+    }
+
+    ColdTier *cold = coldTier();
+    if (cold != nullptr && cold->get(rsc_key, nullptr)) {
+        promoteLocked(rsc_key, rsc_value, hash_val, cold);
+        recordHistory(rsc_key, rsc_value);
+        return OK;
+    }
+    
+    // 添加新条目
+    int result = insertLocked(rsc_key, rsc_value, hash_val);
+    if (result == OK) {
+        recordHistory(rsc_key, rsc_value);
+    }
+    return result == DUPLICATE_KEY ? NO_SPACE_ERR : result;
+}
+
+int OptimizedStatusRscManager::isContain(int rsc_key) {
+    OpTimer timer(this, OP_STAT_CONTAINS, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_READ, rsc_key);
+
+    if (filteredMiss(rsc_key)) {
+        return 0;
+    }
 
+    lockTable();
+    bool found = containsLocked(rsc_key, hash(rsc_key));
+    unlockTable();
+    return found;
+
+}
+
+bool OptimizedStatusRscManager::containsLocked(int rsc_key, uint32_t hash_val) {
+    if (findEntry(rsc_key, hash_val) != -1) {
+        return true;
+    }
+    ColdTier *cold = coldTier();
+    return cold != nullptr && cold->get(rsc_key, nullptr);
 }
 
 int OptimizedStatusRscManager::rscNum() {
-    pthread_mutex_lock(&shared_data_->table_mutex);
-    int count = shared_data_->current_count;
-    pthread_mutex_unlock(&shared_data_->table_mutex);
-    return count;
+    // 计数器分片求和，无需持有table_mutex
+    ColdTier *cold = coldTier();
+    return currentCount() + (cold != nullptr ? cold->count() : 0);
 
 }
 
 int OptimizedStatusRscManager::clearRsc() {
-    pthread_mutex_lock(&shared_data_->table_mutex);
+    OpTimer timer(this, OP_STAT_CLEAR, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    lockTable();
     
-    for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
-        shared_data_->hash_table[i].state = EMPTY;
+    // 递增代数即清空，与表的大小无关
+    advanceGeneration(ks_->active_table.load(std::memory_order_relaxed));
+    setCurrentCount(0);
+    resetDeletedCounts();
+    resetOwnerLists();
+    ks_->layout_epoch++;
+
+    ColdTier *cold = coldTier();
+    if (cold != nullptr) {
+        cold->clear();
+    }
+
+    NegativeFilter filter = negFilter();
+    if (filter.enabled()) {
+        filter.clear();
+    }
+    ValueHistoryData *history = historyData();
+    if (history != nullptr) {
+        ValueHistory(history).clear();
     }
-    shared_data_->current_count = 0;
-    shared_data_->deleted_count = 0;
     
-    pthread_mutex_unlock(&shared_data_->table_mutex);
+    unlockTable();
     return OK;
 
 }
 
 double OptimizedStatusRscManager::getLoadFactor() {
-    pthread_mutex_lock(&shared_data_->table_mutex);
-    double load_factor = static_cast<double>(shared_data_->current_count) / HASH_TABLE_SIZE;
-    pthread_mutex_unlock(&shared_data_->table_mutex);
-    return load_factor;
+    return static_cast<double>(currentCount()) / HASH_TABLE_SIZE;
 
 }
 
 void OptimizedStatusRscManager::printStats() {
-    pthread_mutex_lock(&shared_data_->table_mutex);
+    lockTable();
     
     std::cout << "=== Hash Table Statistics ===" << std::endl;
+    std::cout << "Keyspace: " << ks_->name << std::endl;
     std::cout << "Table Size: " << HASH_TABLE_SIZE << std::endl;
-    std::cout << "Current Count: " << shared_data_->current_count << std::endl;
-    std::cout << "Deleted Count: " << shared_data_->deleted_count << std::endl;
-    std::cout << "Load Factor: " << static_cast<double>(shared_data_->current_count) / HASH_TABLE_SIZE << std::endl;
-    std::cout << "Hash Seed: " << shared_data_->hash_seed << std::endl;
+    std::cout << "Current Count: " << currentCount() << std::endl;
+    std::cout << "Deleted Count: " << deletedCount() << std::endl;
+    std::cout << "Load Factor: " << static_cast<double>(currentCount()) / HASH_TABLE_SIZE << std::endl;
+    std::cout << "Hash Seed: " << ks_->hash_seed << " (generation "
+              << seedGeneration() << ")" << std::endl;
+    std::cout << "Priority Inheritance: " << (ks_->priority_inherit ? "on" : "off") << std::endl;
+    std::cout << "Batch Hash: " << batchHashImpl() << std::endl;
+    RecordSchema schema = recordSchema();
+    if (schema.enabled()) {
+        std::cout << "Record Schema: " << schema.fieldCount() << " fields, "
+                  << schema.recordSize() << " bytes" << std::endl;
+    }
     
     // 计算探测距离统计
     int total_probes = 0;
     int max_probes = 0;
     int occupied_slots = 0;
+    uint32_t generation = tableGeneration();
     
     for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
-        if (shared_data_->hash_table[i].state == OCCUPIED) {
+        if (liveState(table()[i], generation) == OCCUPIED) {
             occupied_slots++;
-            int expected_pos = shared_data_->hash_table[i].hash_value;
+            int expected_pos = table()[i].hash_value;
             int actual_pos = i;
             int probes = 1;
             
             // 计算探测距离
             if (actual_pos != expected_pos) {
-                uint32_t hash2_val = hash2(shared_data_->hash_table[i].key);
+                uint32_t hash2_val = hash2(table()[i].key);
                 int pos = expected_pos;
                 for (int step = 0; step < HASH_TABLE_SIZE; ++step) {
                     if (pos == actual_pos) {
@@ -491,7 +1647,872 @@ void OptimizedStatusRscManager::printStats() {
         std::cout << "Average Probe Distance: " << static_cast<double>(total_probes) / occupied_slots << std::endl;
         std::cout << "Max Probe Distance: " << max_probes << std::endl;
     }
+
+    ColdTier *cold = coldTier();
+    if (cold != nullptr) {
+        std::cout << "Cold Tier: " << cold->path() << std::endl;
+        std::cout << "Cold Tier Count: " << cold->count() << " / " << cold->capacity() << std::endl;
+    }
+
+    HotKeyTracker tracker = hotKeys();
+    if (tracker.enabled()) {
+        tracker.print(std::cout);
+    }
     
-    pthread_mutex_unlock(&shared_data_->table_mutex);
+    unlockTable();
 
 }
+
+void OptimizedStatusRscManager::setHotKeyTracking(bool enabled, int sample_rate) {
+    hotKeys().setEnabled(enabled, sample_rate);
+}
+
+int OptimizedStatusRscManager::getHotKeys(HotKeyOp op, std::vector<HotKeyStat> &hot_keys, int limit) {
+    return hotKeys().topKeys(op, hot_keys, limit);
+}
+
+void OptimizedStatusRscManager::setMetricsEnabled(bool enabled) {
+    ks_->metrics_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void OptimizedStatusRscManager::recordOp(OpStatType op, uint64_t latency_ns) {
+    // 上界为LATENCY_BASE_NS * 2^i的最小桶
+    uint64_t units = (latency_ns + LATENCY_BASE_NS - 1) / LATENCY_BASE_NS;
+    int bucket = units <= 1 ? 0 : 64 - __builtin_clzll(units - 1);
+    if (bucket >= LATENCY_BUCKET_COUNT) {
+        bucket = LATENCY_BUCKET_COUNT - 1;
+    }
+
+    OpStatsShard &stats = ks_->op_stats[counterShardIndex()];
+    stats.op_count[op].fetch_add(1, std::memory_order_relaxed);
+    stats.latency_ns_sum[op].fetch_add(latency_ns, std::memory_order_relaxed);
+    stats.latency_buckets[op][bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void OptimizedStatusRscManager::recordProbes(int probes) {
+    if (!ks_->metrics_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    int bucket = probes <= 1 ? 0 : 64 - __builtin_clzll(static_cast<uint64_t>(probes - 1));
+    if (bucket >= PROBE_BUCKET_COUNT) {
+        bucket = PROBE_BUCKET_COUNT - 1;
+    }
+
+    OpStatsShard &stats = ks_->op_stats[counterShardIndex()];
+    stats.probe_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    stats.probe_sum.fetch_add(probes, std::memory_order_relaxed);
+}
+
+void OptimizedStatusRscManager::collectMetrics(KeyspaceMetrics &metrics) const {
+    metrics.keyspace = ks_->name;
+    metrics.capacity = HASH_TABLE_SIZE;
+    metrics.current_count = currentCount();
+    metrics.deleted_count = deletedCount();
+    memset(metrics.op_count, 0, sizeof(metrics.op_count));
+    memset(metrics.latency_ns_sum, 0, sizeof(metrics.latency_ns_sum));
+    memset(metrics.latency_buckets, 0, sizeof(metrics.latency_buckets));
+    memset(metrics.probe_buckets, 0, sizeof(metrics.probe_buckets));
+    metrics.probe_sum = 0;
+    metrics.lock_acquisitions = 0;
+    metrics.lock_contended = 0;
+    metrics.lock_wait_ns = 0;
+    metrics.filter_negatives = 0;
+    metrics.seed_generation = seedGeneration();
+
+    for (int i = 0; i < COUNTER_SHARDS; ++i) {
+        const OpStatsShard &stats = ks_->op_stats[i];
+        for (int op = 0; op < OP_STAT_COUNT; ++op) {
+            metrics.op_count[op] += stats.op_count[op].load(std::memory_order_relaxed);
+            metrics.latency_ns_sum[op] += stats.latency_ns_sum[op].load(std::memory_order_relaxed);
+            for (int b = 0; b < LATENCY_BUCKET_COUNT; ++b) {
+                metrics.latency_buckets[op][b] +=
+                    stats.latency_buckets[op][b].load(std::memory_order_relaxed);
+            }
+        }
+        for (int b = 0; b < PROBE_BUCKET_COUNT; ++b) {
+            metrics.probe_buckets[b] += stats.probe_buckets[b].load(std::memory_order_relaxed);
+        }
+        metrics.probe_sum += stats.probe_sum.load(std::memory_order_relaxed);
+        metrics.lock_acquisitions += stats.lock_acquisitions.load(std::memory_order_relaxed);
+        metrics.lock_contended += stats.lock_contended.load(std::memory_order_relaxed);
+        metrics.lock_wait_ns += stats.lock_wait_ns.load(std::memory_order_relaxed);
+        metrics.filter_negatives += stats.filter_negatives.load(std::memory_order_relaxed);
+    }
+}
+
+bool OptimizedStatusRscManager::filteredMiss(int key) {
+    NegativeFilter filter = negFilter();
+    if (!filter.enabled() || filter.mayContain(key)) {
+        return false;
+    }
+    if (ks_->metrics_enabled.load(std::memory_order_relaxed)) {
+        ks_->op_stats[counterShardIndex()].filter_negatives.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+int OptimizedStatusRscManager::setNegativeFilter(bool enabled) {
+    lockTable();
+
+    NegativeFilter filter = negFilter();
+    if (!enabled) {
+        filter.setEnabled(false);
+        unlockTable();
+        return OK;
+    }
+    if (filter.enabled()) {
+        unlockTable();
+        return OK;
+    }
+
+    // 关闭期间写操作不维护过滤器，启用前按热表和冷数据层的内容重建
+    filter.clear();
+    uint32_t generation = tableGeneration();
+    for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
+        if (liveState(table()[i], generation) == OCCUPIED) {
+            filter.add(table()[i].key);
+        }
+    }
+    ColdTier *cold = coldTier();
+    if (cold != nullptr) {
+        std::map<int, std::string> cold_entries;
+        cold->collect(cold_entries);
+        for (const auto &pair : cold_entries) {
+            filter.add(pair.first);
+        }
+    }
+    filter.setEnabled(true);
+
+    unlockTable();
+    return OK;
+}
+
+static const int REFRESH_PID_BITS = 22;
+
+// refresh_owner的取值：pid与启动时刻合成一个字，接管时一次CAS同时替换两者
+static uint64_t refreshToken(int pid) {
+    return (OwnerRegistry::processStartTime(pid) << REFRESH_PID_BITS) | static_cast<uint64_t>(pid);
+}
+
+static int refreshPid(uint64_t token) {
+    return static_cast<int>(token & ((1ULL << REFRESH_PID_BITS) - 1));
+}
+
+int OptimizedStatusRscManager::bulkRefresh(const std::map<int, std::string> &contents) {
+    if (recordSchema().enabled()) {
+        return -1;
+    }
+    if (contents.size() > static_cast<size_t>(MAX_ENTRIES)) {
+        return NO_SPACE_ERR;
+    }
+
+    // 占有非活动表；持有者已退出（含pid已被复用）时接管
+    int self = static_cast<int>(getpid());
+    uint64_t token = refreshToken(self);
+    uint64_t owner = 0;
+    while (!ks_->refresh_owner.compare_exchange_strong(owner, token)) {
+        int owner_pid = refreshPid(owner);
+        if (owner_pid == self ||
+            OwnerRegistry::processAlive(owner_pid, owner >> REFRESH_PID_BITS)) {
+            return -1;  // 其他进程（或本进程的其他线程）正在装载
+        }
+    }
+
+    // 只有占有者会切换active_table，此处无需加锁
+    int inactive = 1 - ks_->active_table.load(std::memory_order_acquire);
+    HashEntry *target = ks_->hash_tables[inactive];
+    std::random_device rd;
+    uint32_t seed = rd();
+
+    advanceGeneration(inactive);
+    uint32_t generation = ks_->table_generation[inactive];
+    static thread_local BatchHashes hashes;
+    hashes.assign(contents);
+    hashes.compute(0, seed);
+    int loaded = 0;
+    size_t index = 0;
+    for (auto it = contents.begin(); it != contents.end(); ++it, ++index) {
+        const auto &pair = *it;
+        if (pair.second.empty() || pair.second.length() >= MAX_VALUE_LEN) {
+            continue;
+        }
+        // 键各不相同，探测到空槽即可写入
+        uint32_t hash_val = hashes.hash1(index);
+        uint32_t hash2_val = hashes.hash2(index);
+        int pos = hash_val;
+        for (int step = 0; liveState(target[pos], generation) != EMPTY; ++step) {
+            pos = getNextProbe(pos, step + 1, hash2_val);
+        }
+        HashEntry &entry = target[pos];
+        entry.key = pair.first;
+        strncpy(entry.value, pair.second.c_str(), MAX_VALUE_LEN - 1);
+        entry.value[MAX_VALUE_LEN - 1] = '\0';
+        entry.hash_value = hash_val;
+        entry.referenced = 0;
+        entry.owner = 0;
+        entry.generation = generation;
+        entry.state = OCCUPIED;
+        loaded++;
+    }
+
+    // 切换：以下全部在一次持锁内完成，读者看到的要么是旧表要么是新表
+    lockTable();
+
+    // 无锁读者只在查询前检查一次enabled，过滤器全程须是两张表键集合的超集：
+    // 切换前加入新表的键，切换后再减去旧表与冷数据层的键
+    NegativeFilter filter = negFilter();
+    bool filter_enabled = filter.enabled();
+    if (filter_enabled) {
+        for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
+            if (liveState(target[i], generation) == OCCUPIED) {
+                filter.add(target[i].key);
+            }
+        }
+    }
+    HashEntry *previous = ks_->hash_tables[1 - inactive];
+    uint32_t previous_generation = ks_->table_generation[1 - inactive];
+
+    ks_->hash_seed = seed;
+    ks_->seed_generation.fetch_add(1, std::memory_order_release);
+    ks_->long_probe_inserts = 0;
+    ks_->inserts_since_reseed = 0;
+    ks_->clock_hand = 0;
+    resetOwnerLists();  // 装载的条目均无主
+    ks_->active_table.store(inactive, std::memory_order_release);
+    ks_->layout_epoch++;
+    setCurrentCount(loaded);
+    resetDeletedCounts();
+
+    if (filter_enabled) {
+        for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
+            if (liveState(previous[i], previous_generation) == OCCUPIED) {
+                filter.remove(previous[i].key);
+            }
+        }
+    }
+    ColdTier *cold = coldTier();
+    if (cold != nullptr) {
+        if (filter_enabled) {
+            std::map<int, std::string> cold_entries;
+            cold->collect(cold_entries);
+            for (const auto &pair : cold_entries) {
+                filter.remove(pair.first);
+            }
+        }
+        cold->clear();
+    }
+    // 整表替换不逐键追加历史，旧内容的历史随旧表一起丢弃
+    ValueHistoryData *history = historyData();
+    if (history != nullptr) {
+        ValueHistory(history).clear();
+    }
+
+    unlockTable();
+
+    ks_->refresh_owner.store(0, std::memory_order_release);
+    return loaded;
+}
+
+void OptimizedStatusRscManager::storeValue(char *dest, const char *value) const {
+    int record_size = recordSchema().recordSize();
+    if (record_size > 0) {
+        memcpy(dest, value, record_size);
+        return;
+    }
+    strncpy(dest, value, MAX_VALUE_LEN - 1);
+    dest[MAX_VALUE_LEN - 1] = '\0';
+}
+
+std::string OptimizedStatusRscManager::loadValue(const char *value) const {
+    int record_size = recordSchema().recordSize();
+    if (record_size > 0) {
+        return std::string(value, record_size);
+    }
+    return std::string(value);
+}
+
+int OptimizedStatusRscManager::setRecordSchema(const std::vector<RecordField> &fields) {
+    RecordSchemaData schema;
+    RecordSchema::init(&schema);
+    int result = RecordSchema::build(fields, MAX_VALUE_LEN, &schema);
+    if (result != OK) {
+        return result;
+    }
+
+    lockTable();
+    RecordSchema current = recordSchema();
+    if (current.sameAs(schema)) {
+        unlockTable();
+        return OK;
+    }
+    // 已有条目按旧布局（或字符串）保存，不能就地更换
+    if (currentCount() > 0 || ks_->cold_tier_enabled.load(std::memory_order_relaxed)) {
+        unlockTable();
+        return -1;
+    }
+    current.assign(schema);
+    unlockTable();
+    return OK;
+}
+
+int OptimizedStatusRscManager::lockRecord(int key, char **record) {
+    if (!recordSchema().enabled()) {
+        return -1;
+    }
+    if (filteredMiss(key)) {
+        return NOT_FOUND;
+    }
+
+    lockTable();
+    int pos = findEntry(key, hash(key));
+    if (pos == -1) {
+        unlockTable();
+        return NOT_FOUND;
+    }
+    HashEntry &entry = table()[pos];
+    entry.referenced = 1;
+    *record = entry.value;
+    return OK;
+}
+
+int OptimizedStatusRscManager::putRecord(int key, const void *record) {
+    OpTimer timer(this, OP_STAT_UPSERT, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_WRITE, key);
+    if (!recordSchema().enabled()) {
+        return -1;
+    }
+
+    const char *value = static_cast<const char *>(record);
+    lockTable();
+    uint32_t hash_val = hash(key);
+    int pos = findEntry(key, hash_val);
+    int result = OK;
+    if (pos != -1) {
+        HashEntry &entry = table()[pos];
+        storeValue(entry.value, value);
+        entry.referenced = 1;
+        ownWriteLocked(pos);
+    } else {
+        result = insertLocked(key, value, hash_val);
+    }
+    if (result == OK) {
+        recordHistory(key, value);
+    }
+    unlockTable();
+    return result;
+}
+
+int OptimizedStatusRscManager::getRecord(int key, void *record) {
+    OpTimer timer(this, OP_STAT_GET, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_READ, key);
+    char *stored = nullptr;
+    int result = lockRecord(key, &stored);
+    if (result != OK) {
+        return result;
+    }
+    memcpy(record, stored, recordSchema().recordSize());
+    unlockTable();
+    return OK;
+}
+
+int OptimizedStatusRscManager::getField(int key, int field, int64_t *value) {
+    OpTimer timer(this, OP_STAT_GET, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_READ, key);
+    char *record = nullptr;
+    int result = lockRecord(key, &record);
+    if (result != OK) {
+        return result;
+    }
+    result = recordSchema().readInt(record, field, value);
+    unlockTable();
+    return result;
+}
+
+int OptimizedStatusRscManager::getField(int key, int field, double *value) {
+    OpTimer timer(this, OP_STAT_GET, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_READ, key);
+    char *record = nullptr;
+    int result = lockRecord(key, &record);
+    if (result != OK) {
+        return result;
+    }
+    result = recordSchema().readDouble(record, field, value);
+    unlockTable();
+    return result;
+}
+
+int OptimizedStatusRscManager::getField(int key, int field, std::string *value) {
+    OpTimer timer(this, OP_STAT_GET, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_READ, key);
+    char *record = nullptr;
+    int result = lockRecord(key, &record);
+    if (result != OK) {
+        return result;
+    }
+    result = recordSchema().readChars(record, field, value);
+    unlockTable();
+    return result;
+}
+
+int OptimizedStatusRscManager::setField(int key, int field, int64_t value) {
+    OpTimer timer(this, OP_STAT_UPDATE, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_WRITE, key);
+    char *record = nullptr;
+    int result = lockRecord(key, &record);
+    if (result != OK) {
+        return result;
+    }
+    result = recordSchema().writeInt(record, field, value);
+    if (result == OK) {
+        ownWriteLocked(recordSlot(record));
+        recordHistory(key, record);
+    }
+    unlockTable();
+    return result;
+}
+
+int OptimizedStatusRscManager::setField(int key, int field, double value) {
+    OpTimer timer(this, OP_STAT_UPDATE, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_WRITE, key);
+    char *record = nullptr;
+    int result = lockRecord(key, &record);
+    if (result != OK) {
+        return result;
+    }
+    result = recordSchema().writeDouble(record, field, value);
+    if (result == OK) {
+        ownWriteLocked(recordSlot(record));
+        recordHistory(key, record);
+    }
+    unlockTable();
+    return result;
+}
+
+int OptimizedStatusRscManager::setField(int key, int field, const std::string &value) {
+    OpTimer timer(this, OP_STAT_UPDATE, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_WRITE, key);
+    char *record = nullptr;
+    int result = lockRecord(key, &record);
+    if (result != OK) {
+        return result;
+    }
+    result = recordSchema().writeChars(record, field, value);
+    if (result == OK) {
+        ownWriteLocked(recordSlot(record));
+        recordHistory(key, record);
+    }
+    unlockTable();
+    return result;
+}
+
+int OptimizedStatusRscManager::addField(int key, int field, int64_t delta, int64_t *result_value) {
+    OpTimer timer(this, OP_STAT_UPDATE, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    hotKeys().record(HOT_KEY_WRITE, key);
+    char *record = nullptr;
+    int result = lockRecord(key, &record);
+    if (result != OK) {
+        return result;
+    }
+    result = recordSchema().addInt(record, field, delta, result_value);
+    if (result == OK) {
+        ownWriteLocked(recordSlot(record));
+        recordHistory(key, record);
+    }
+    unlockTable();
+    return result;
+}
+
+int OptimizedStatusRscManager::setValueHistory(bool enabled, int depth, int value_len) {
+    size_t size = ValueHistory::requiredSize(depth, value_len, HASH_TABLE_SIZE);
+    if (enabled && size == 0) {
+        return -1;
+    }
+
+    lockTable();
+    ValueHistoryData *current = historyData();
+    SharedArena arena(&shared_data_->arena);
+    if (!enabled) {
+        if (current != nullptr) {
+            ks_->history_offset = 0;
+            arena.deallocate(current);
+        }
+        unlockTable();
+        return OK;
+    }
+    if (current != nullptr) {
+        bool same = current->depth == static_cast<uint32_t>(depth) &&
+                    current->value_len == static_cast<uint32_t>(value_len);
+        unlockTable();
+        return same ? OK : -1;
+    }
+
+    ValueHistoryData *data = static_cast<ValueHistoryData *>(arena.allocate(size));
+    if (data == nullptr) {
+        unlockTable();
+        return NO_SPACE_ERR;
+    }
+    std::random_device rd;
+    ValueHistory::init(data, depth, value_len, HASH_TABLE_SIZE, rd());
+    ks_->history_offset = reinterpret_cast<char *>(data) - reinterpret_cast<char *>(&shared_data_->arena);
+    unlockTable();
+    return OK;
+}
+
+int OptimizedStatusRscManager::getHistory(int key, std::vector<HistoryEntry> &entries, int limit) {
+    OpTimer timer(this, OP_STAT_GET, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    entries.clear();
+    lockTable();
+    ValueHistoryData *data = historyData();
+    int result = data != nullptr ? ValueHistory(data).get(key, entries, limit) : -1;
+    unlockTable();
+    return result;
+}
+
+ValueHistoryData *OptimizedStatusRscManager::historyData() const {
+    if (ks_->history_offset == 0) {
+        return nullptr;
+    }
+    return reinterpret_cast<ValueHistoryData *>(reinterpret_cast<char *>(&shared_data_->arena) +
+                                                ks_->history_offset);
+}
+
+void OptimizedStatusRscManager::recordHistory(int key, const char *value) {
+    ValueHistoryData *data = historyData();
+    if (data == nullptr) {
+        return;
+    }
+    int record_size = recordSchema().recordSize();
+    size_t length = record_size > 0 ? record_size : strnlen(value, MAX_VALUE_LEN);
+    uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch()).count();
+    ValueHistory(data).append(key, value, length, now);
+}
+
+int OptimizedStatusRscManager::enableOwnerTracking() {
+    lockTable();
+    if (ks_->cold_tier_enabled.load(std::memory_order_relaxed)) {
+        unlockTable();
+        return -1;
+    }
+    ks_->owner_tracking.store(true, std::memory_order_relaxed);
+    unlockTable();
+    return OK;
+}
+
+int OptimizedStatusRscManager::reclaimDeadOwners() {
+    lockTable();
+    owners().checkLiveness(0);
+    int reclaimed = reclaimDeadLocked(0);
+    unlockTable();
+    return reclaimed;
+}
+
+void OptimizedStatusRscManager::linkOwner(int pos, uint16_t owner) {
+    HashEntry &entry = table()[pos];
+    int16_t &head = ks_->owner_heads[owner - 1];
+    if (head == -1) {
+        owners().markKeyspace(owner, keyspaceIndex());
+    } else {
+        table()[head].owner_prev = static_cast<int16_t>(pos);
+    }
+    entry.owner = owner;
+    entry.owner_prev = -1;
+    entry.owner_next = head;
+    head = static_cast<int16_t>(pos);
+}
+
+void OptimizedStatusRscManager::unlinkOwner(int pos) {
+    HashEntry &entry = table()[pos];
+    if (entry.owner == 0) {
+        return;
+    }
+    int16_t &head = ks_->owner_heads[entry.owner - 1];
+    if (entry.owner_prev == -1) {
+        head = entry.owner_next;
+    } else {
+        table()[entry.owner_prev].owner_next = entry.owner_next;
+    }
+    if (entry.owner_next != -1) {
+        table()[entry.owner_next].owner_prev = entry.owner_prev;
+    }
+    if (head == -1) {
+        owners().unmarkKeyspace(entry.owner, keyspaceIndex());
+    }
+    entry.owner = 0;
+}
+
+void OptimizedStatusRscManager::resetOwnerLists() {
+    OwnerRegistry registry = owners();
+    for (int i = 0; i < MAX_OWNERS; ++i) {
+        if (ks_->owner_heads[i] != -1) {
+            ks_->owner_heads[i] = -1;
+            registry.unmarkKeyspace(static_cast<uint16_t>(i + 1), keyspaceIndex());
+        }
+    }
+}
+
+void OptimizedStatusRscManager::rebuildOwnerLists() {
+    // 先按条目中的标记重新串链，再注销已没有条目的所有者；
+    // 不能先全部注销，否则已退出进程的编号可能在条目仍在表中时被释放并重新分配
+    bool had_entries[MAX_OWNERS];
+    for (int i = 0; i < MAX_OWNERS; ++i) {
+        had_entries[i] = ks_->owner_heads[i] != -1;
+        ks_->owner_heads[i] = -1;
+    }
+    uint32_t generation = tableGeneration();
+    for (int pos = HASH_TABLE_SIZE - 1; pos >= 0; --pos) {
+        HashEntry &entry = table()[pos];
+        if (liveState(entry, generation) != OCCUPIED || entry.owner == 0) {
+            continue;
+        }
+        int16_t &head = ks_->owner_heads[entry.owner - 1];
+        if (head != -1) {
+            table()[head].owner_prev = static_cast<int16_t>(pos);
+        } else if (!had_entries[entry.owner - 1]) {
+            owners().markKeyspace(entry.owner, keyspaceIndex());
+        }
+        entry.owner_prev = -1;
+        entry.owner_next = head;
+        head = static_cast<int16_t>(pos);
+    }
+    for (int i = 0; i < MAX_OWNERS; ++i) {
+        if (had_entries[i] && ks_->owner_heads[i] == -1) {
+            owners().unmarkKeyspace(static_cast<uint16_t>(i + 1), keyspaceIndex());
+        }
+    }
+}
+
+void OptimizedStatusRscManager::ownWriteLocked(int pos) {
+    if (!ks_->owner_tracking.load(std::memory_order_relaxed)) {
+        return;
+    }
+    OwnerRegistry registry = owners();
+    uint16_t self = registry.self();
+    if (table()[pos].owner != self) {
+        unlinkOwner(pos);
+        if (self != 0) {
+            linkOwner(pos, self);
+        }
+    }
+
+    // 存活检查与回收分摊到各次写入，单次写入的额外开销有上限
+    if (--ks_->owner_check_countdown <= 0) {
+        ks_->owner_check_countdown = OWNER_CHECK_INTERVAL;
+        registry.checkLiveness(OWNER_CHECK_SLOTS);
+    }
+    reclaimDeadLocked(OWNER_RECLAIM_BATCH);
+}
+
+int OptimizedStatusRscManager::reclaimDeadLocked(int limit) {
+    OwnerRegistry registry = owners();
+    if (!registry.hasDead()) {
+        return 0;
+    }
+    NegativeFilter filter = negFilter();
+    ValueHistoryData *history = historyData();
+    int reclaimed = 0;
+    for (int i = 0; i < MAX_OWNERS && (limit <= 0 || reclaimed < limit); ++i) {
+        if (ks_->owner_heads[i] == -1 || !registry.isDead(static_cast<uint16_t>(i + 1))) {
+            continue;
+        }
+        // 沿所有者链表逐条删除，链表取尽时unlinkOwner注销该键空间的标记
+        while (ks_->owner_heads[i] != -1 && (limit <= 0 || reclaimed < limit)) {
+            int pos = ks_->owner_heads[i];
+            HashEntry &entry = table()[pos];
+            unlinkOwner(pos);
+            entry.state = DELETED;
+            adjustCounts(-1, 1);
+            if (filter.enabled()) {
+                filter.remove(entry.key);
+            }
+            if (history != nullptr) {
+                ValueHistory(history).drop(entry.key);
+            }
+            reclaimed++;
+        }
+    }
+    ks_->owner_reclaimed += reclaimed;
+    return reclaimed;
+}
+
+void OptimizedStatusRscManager::scanRange(ScanArena &out, int begin, int end, ColdTier *cold,
+                                          uint32_t generation) const {
+    int record_size = recordSchema().recordSize();
+    int hot_end = std::min(end, HASH_TABLE_SIZE);
+    for (int i = begin; i < hot_end; ++i) {
+        const HashEntry &entry = table()[i];
+        if (liveState(entry, generation) == OCCUPIED) {
+            size_t length = record_size > 0 ? record_size : strnlen(entry.value, MAX_VALUE_LEN);
+            out.append(entry.key, entry.value, length);
+        }
+    }
+    if (cold != nullptr && end > HASH_TABLE_SIZE) {
+        cold->collect(out, std::max(begin, HASH_TABLE_SIZE) - HASH_TABLE_SIZE, end - HASH_TABLE_SIZE);
+    }
+}
+
+int OptimizedStatusRscManager::parallelScan(int threads, std::vector<ScanArena> &parts, bool sorted) {
+    OpTimer timer(this, OP_STAT_BATCH_GET, ks_->metrics_enabled.load(std::memory_order_relaxed));
+    if (threads <= 0) {
+        return -1;
+    }
+    parts.clear();
+    parts.resize(threads);
+
+    // 按加锁前的大小预留输出区，持锁期间尽量不再分配内存
+    ColdTier *cold = coldTier();
+    size_t per_thread = (HASH_TABLE_SIZE + (cold != nullptr ? cold->capacity() : 0)) / threads + 1;
+
+    std::promise<void> start;
+    std::shared_future<void> go = start.get_future().share();
+    std::vector<std::pair<int, int>> ranges(threads, std::make_pair(0, 0));
+    uint32_t generation = 0;
+    std::vector<std::thread> workers;
+    try {
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                parts[t].reserve(per_thread, per_thread * MAX_VALUE_LEN / 4);
+                go.wait();
+                scanRange(parts[t], ranges[t].first, ranges[t].second, cold, generation);
+            });
+        }
+    } catch (const std::system_error &e) {
+        std::cerr << "Error starting scan threads: " << e.what() << std::endl;
+        start.set_value();  // 区间均为空，已创建的线程立即退出
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        return -1;
+    }
+
+    lockTable();
+    cold = coldTier();
+    int total = HASH_TABLE_SIZE + (cold != nullptr ? cold->capacity() : 0);
+    int chunk = (total + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t) {
+        ranges[t].first = std::min(t * chunk, total);
+        ranges[t].second = std::min(ranges[t].first + chunk, total);
+    }
+    generation = tableGeneration();
+    start.set_value();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    unlockTable();
+
+    int count = 0;
+    for (const ScanArena &part : parts) {
+        count += static_cast<int>(part.size());
+    }
+    if (!sorted) {
+        return count;
+    }
+
+    // 排序与归并在锁外进行
+    workers.clear();
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back([&parts, t]() { sortArena(parts[t]); });
+    }
+    sortArena(parts[0]);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    if (threads > 1) {
+        ScanArena merged;
+        mergeSortedArenas(parts, merged);
+        parts.resize(1);
+        std::swap(parts[0], merged);
+    }
+    return count;
+}
+
+int OptimizedStatusRscManager::publishSnapshot(int threads) {
+    std::vector<ScanArena> parts;
+    if (parallelScan(threads, parts) < 0) {
+        return -1;
+    }
+    return buildSnapshot(parts, ks_->hash_seed, ks_->name);
+}
+
+int OptimizedStatusRscManager::publishSnapshot(const std::string &name, int threads) {
+    int fd = publishSnapshot(threads);
+    if (fd == -1) {
+        return -1;
+    }
+    int result = registerSnapshot(sharedArena(), name, fd);
+    close(fd);
+    return result;
+}
+
+int OptimizedStatusRscManager::applySubmissions(const RingSubmission *submissions, int count,
+                                                RingCompletion *completions) {
+    // 直接调用各操作的持锁版本：不再逐项计时、统计锁等待或构造临时字符串，
+    // 参数检查与同步接口一致；热点键按批量操作的方式逐项记录
+    HotKeyTracker tracker = hotKeys();
+    char value[MAX_VALUE_LEN];
+    int work_in_section = 0;
+    lockTable();
+    for (int i = 0; i < count; ++i) {
+        const RingSubmission &submission = submissions[i];
+        RingCompletion &completion = completions[i];
+        completion.user_data = submission.user_data;
+        completion.value_len = 0;
+        if (submission.value_len > static_cast<uint32_t>(MAX_VALUE_LEN)) {
+            completion.result = -1;
+            continue;
+        }
+        yieldTableIfNeeded(work_in_section);
+
+        int key = submission.key;
+        bool is_write = submission.opcode == RING_OP_ADD || submission.opcode == RING_OP_UPDATE ||
+                        submission.opcode == RING_OP_UPSERT;
+        if (is_write) {
+            tracker.record(HOT_KEY_WRITE, key);
+            if (submission.value_len == 0 || recordSchema().enabled()) {
+                completion.result = -1;
+                continue;
+            }
+            if (submission.value_len >= static_cast<uint32_t>(MAX_VALUE_LEN)) {
+                completion.result = NO_SPACE_ERR;
+                continue;
+            }
+            memcpy(value, submission.value, submission.value_len);
+            value[submission.value_len] = '\0';
+        }
+
+        switch (submission.opcode) {
+        case RING_OP_NOP:
+            completion.result = OK;
+            break;
+        case RING_OP_ADD:
+            completion.result = addLocked(key, value, hash(key));
+            break;
+        case RING_OP_UPDATE:
+            completion.result = filteredMiss(key) ? NOT_FOUND : updateLocked(key, value, hash(key));
+            break;
+        case RING_OP_UPSERT:
+            completion.result = upsertLocked(key, value, hash(key));
+            break;
+        case RING_OP_GET: {
+            tracker.record(HOT_KEY_READ, key);
+            int len = filteredMiss(key) ? NOT_FOUND : getLocked(key, hash(key), completion.value);
+            completion.result = len < 0 ? NOT_FOUND : OK;
+            completion.value_len = len < 0 ? 0 : static_cast<uint32_t>(len);
+            break;
+        }
+        case RING_OP_REMOVE:
+            tracker.record(HOT_KEY_WRITE, key);
+            completion.result = filteredMiss(key) ? NOT_FOUND : removeLocked(key, hash(key));
+            break;
+        case RING_OP_CONTAINS:
+            tracker.record(HOT_KEY_READ, key);
+            completion.result = !filteredMiss(key) && containsLocked(key, hash(key));
+            break;
+        default:
+            completion.result = -1;
+            break;
+        }
+    }
+    unlockTable();
+    return count;
+}
@@ -1,19 +1,82 @@
 #pragma once
 
+#include "async_ring.h"
+#include "batch_hash.h"
+#include "hot_key_tracker.h"
+#include "negative_filter.h"
+#include "owner_registry.h"
+#include "record_schema.h"
+#include "shared_arena.h"
 #include "shared_memory_inteface.h"
+#include "snapshot.h"
+#include "table_scan.h"
+#include "value_history.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <pthread.h>
 #include <string>
+#include <vector>
 
 #define OK 0
 #define NOT_FOUND -1
 #define NO_SPACE_ERR -2
 #define DUPLICATE_KEY -3
+#define IO_ERR -4
 
 const int MAX_VALUE_LEN = 256;
 const int HASH_TABLE_SIZE = 2048;    // 使用2的幂次，便于位运算优化
 const double MAX_LOAD_FACTOR = 0.75; // 最大负载因子
 const int MAX_ENTRIES = static_cast<int>(HASH_TABLE_SIZE * MAX_LOAD_FACTOR);
+const int CACHE_LINE_SIZE = 64;
+const int COUNTER_SHARDS = 16; // 计数器分片数，2的幂次
+const int MAX_KEYSPACES = 8;   // 单个共享内存段内的最大键空间数
+const int MAX_KEYSPACE_NAME_LEN = 32;
+const char *const DEFAULT_KEYSPACE_NAME = "default";
+
+// 冷热分层：热表条目数超过高水位时按CLOCK算法降级到冷数据层，直到低于低水位
+const int HOT_TIER_HIGH_WATERMARK = MAX_ENTRIES * 9 / 10;
+const int HOT_TIER_LOW_WATERMARK = MAX_ENTRIES * 7 / 10;
+const int COLD_TIER_PATH_LEN = 256;
+const int COLD_TIER_DEFAULT_CAPACITY = 1 << 16;
+
+// 自适应重新选种：插入探测长度超过阈值记为一次长链，自上次选种以来长链次数达到上限、
+// 且至少经过RESEED_MIN_INSERTS次插入时换用新种子rehash，避免对抗性键集反复触发
+const int RESEED_PROBE_THRESHOLD = 32;
+const int RESEED_LONG_PROBE_LIMIT = 8;
+const int RESEED_MIN_INSERTS = HASH_TABLE_SIZE / 8;
+
+// 所有者标记：写者每OWNER_CHECK_INTERVAL次写入检查OWNER_CHECK_SLOTS个登记槽位的存活，
+// 每次写入最多回收OWNER_RECLAIM_BATCH个已退出进程的条目
+const int OWNER_CHECK_INTERVAL = 64;
+const int OWNER_CHECK_SLOTS = 4;
+const int OWNER_RECLAIM_BATCH = 8;
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2,
+              "std::atomic<int> must be lock-free to live in shared memory");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "std::atomic<uint64_t> must be lock-free to live in shared memory");
+
+// 运行时统计：操作类型、延迟直方图（上界为LATENCY_BASE_NS * 2^i）、探测长度直方图（上界2^i）
+enum OpStatType {
+  OP_STAT_ADD = 0,
+  OP_STAT_GET,
+  OP_STAT_UPDATE,
+  OP_STAT_UPSERT,
+  OP_STAT_REMOVE,
+  OP_STAT_CONTAINS,
+  OP_STAT_BATCH_UPDATE,
+  OP_STAT_BATCH_UPSERT,
+  OP_STAT_BATCH_GET,
+  OP_STAT_CLEAR,
+  OP_STAT_COUNT
+};
+const int LATENCY_BUCKET_COUNT = 16;
+const uint64_t LATENCY_BASE_NS = 128;
+const int PROBE_BUCKET_COUNT = 12;
 
 // 哈希表条目状态
 enum EntryState {
@@ -24,24 +87,200 @@ enum EntryState {
 
 struct HashEntry {
   int key;
-  char value[MAX_VALUE_LEN];
+  // 同一所有者的条目组成双向链表（仅活动表），-1表示链表端点；占用key之后的对齐空隙
+  int16_t owner_prev;
+  int16_t owner_next;
+  alignas(8) char value[MAX_VALUE_LEN]; // 8字节对齐，定长记录中的数值字段按自身大小对齐
+
   EntryState state;
   uint32_t hash_value; // 缓存哈希值，减少重复计算
+  uint8_t referenced;  // CLOCK访问位，冷热分层时用于挑选降级条目
+  uint16_t owner;      // 写入进程在登记表中的编号，0表示无主
+  uint32_t generation; // 写入时所在表的代数，与表的当前代数不同即视为空槽
+};
+
+static_assert(HASH_TABLE_SIZE <= 32768, "owner list links are 16-bit slot indexes");
+
+// 计数器分片，每个分片独占一个缓存行，避免不同CPU上的写者互相抢占
+// 单个分片的值可能为负，只有所有分片之和才有意义
+struct alignas(CACHE_LINE_SIZE) CounterShard {
+  std::atomic<int> current_count; // 实际使用的条目数（增量）
+  std::atomic<int> deleted_count; // 已删除的条目数（增量）
+};
+
+// 运行时统计分片，与计数器分片使用相同的CPU映射，导出时求和
+// 最后一个直方图桶同时承担+Inf
+struct alignas(CACHE_LINE_SIZE) OpStatsShard {
+  std::atomic<uint64_t> op_count[OP_STAT_COUNT];
+  std::atomic<uint64_t> latency_ns_sum[OP_STAT_COUNT];
+  std::atomic<uint64_t> latency_buckets[OP_STAT_COUNT][LATENCY_BUCKET_COUNT];
+  std::atomic<uint64_t> probe_buckets[PROBE_BUCKET_COUNT];
+  std::atomic<uint64_t> probe_sum;
+  std::atomic<uint64_t> lock_acquisitions;
+  std::atomic<uint64_t> lock_contended; // trylock失败后阻塞等待的次数
+  std::atomic<uint64_t> lock_wait_ns;
+  std::atomic<uint64_t> filter_negatives; // 由负查找过滤器直接应答的未命中
+};
+
+// 统计快照（所有分片之和），读取时不持有table_mutex
+struct KeyspaceMetrics {
+  std::string keyspace;
+  int capacity;
+  int current_count;
+  int deleted_count;
+  uint64_t op_count[OP_STAT_COUNT];
+  uint64_t latency_ns_sum[OP_STAT_COUNT];
+  uint64_t latency_buckets[OP_STAT_COUNT][LATENCY_BUCKET_COUNT];
+  uint64_t probe_buckets[PROBE_BUCKET_COUNT];
+  uint64_t probe_sum;
+  uint64_t lock_acquisitions;
+  uint64_t lock_contended;
+  uint64_t lock_wait_ns;
+  uint64_t filter_negatives;
+  uint64_t seed_generation;
+};
+
+// 进程级锁选项，对之后的操作生效
+struct LockOptions {
+  LockOptions() : priority_inherit(false), max_batch_per_lock(0) {}
+
+  // 本进程此后创建的段和键空间使用优先级继承锁；已存在的锁保持创建时的协议
+  bool priority_inherit;
+  // 批量操作单次持有table_mutex处理的最大条目（batchGetRsc为槽位）数，
+  // 达到后释放锁让等待者先执行；<=0表示整个批量操作只加一次锁
+  int max_batch_per_lock;
+};
+
+// 键空间：拥有独立的哈希表区域、锁和计数器，相同的key在不同键空间互不影响
+struct KeyspaceData {
+  // 只读为主区域：创建后不再修改，每次查找都会读取
+  alignas(CACHE_LINE_SIZE) volatile bool in_use;
+  uint32_t hash_seed; // 哈希种子，用于防止哈希攻击；重新选种时在table_mutex下修改
+  std::atomic<uint32_t> seed_generation; // 每次重新选种后递增
+  char name[MAX_KEYSPACE_NAME_LEN];
+  std::atomic<bool> cold_tier_enabled; // 启用后不再关闭
+  int cold_tier_capacity;
+  char cold_tier_path[COLD_TIER_PATH_LEN];
+  std::atomic<bool> metrics_enabled; // 操作计数、延迟与锁竞争统计开关，默认关闭
+  bool priority_inherit;             // table_mutex是否为优先级继承锁
+  RecordSchemaData record_schema;    // 定长记录布局，未注册时field_count为0
+  // 取值历史存储在通用内存区中的偏移，0表示未启用；在table_mutex下修改
+  uint64_t history_offset;
+  std::atomic<bool> owner_tracking; // 启用后不再关闭
+
+  // 写入频繁区域：锁与计数器各自独占缓存行，不与只读区域共享
+  alignas(CACHE_LINE_SIZE) pthread_mutex_t table_mutex;
+  int clock_hand; // 降级扫描位置，受table_mutex保护
+  int long_probe_inserts;   // 自上次选种以来的长链插入次数，受table_mutex保护
+  int inserts_since_reseed; // 受table_mutex保护
+  // 条目在槽位或冷热层之间移动时递增，分段批量读取据此判断是否需要重新开始
+  uint32_t layout_epoch;
+  // 所有者标记，受table_mutex保护：各所有者在活动表中的链表头，-1表示空
+  int16_t owner_heads[MAX_OWNERS];
+  int owner_check_countdown;
+  uint64_t owner_reclaimed; // 累计回收的条目数
+  CounterShard counters[COUNTER_SHARDS];
+
+  OpStatsShard op_stats[COUNTER_SHARDS];
+
+  // 可选的热点键统计，与table_mutex无关
+  alignas(CACHE_LINE_SIZE) HotKeyTrackerData hot_keys;
+
+  // 可选的负查找过滤器，覆盖热表与冷数据层中的所有键，查询无锁
+  alignas(CACHE_LINE_SIZE) NegativeFilterData neg_filter;
+
+  // 双缓冲：active_table指向当前表，另一张供bulkRefresh无锁构建新内容
+  std::atomic<int> active_table;  // 只在持有table_mutex时切换
+  // 正在构建非活动表的进程，0表示空闲；低22位为pid（Linux的pid上限），
+  // 其余位为该进程的启动时刻，用于识别pid复用
+  std::atomic<uint64_t> refresh_owner;
+  // 各表的当前代数，递增即清空整表；活动表受table_mutex保护，非活动表归refresh_owner
+  uint32_t table_generation[2];
+  alignas(CACHE_LINE_SIZE) HashEntry hash_tables[2][HASH_TABLE_SIZE];
+};
+
+// 段布局版本：修改HashEntry、KeyspaceData或OptimizedSharedData后必须递增
+const uint32_t SEGMENT_MAGIC = 0x4f53534d; // "OSSM"
+const uint32_t SEGMENT_LAYOUT_VERSION = 12;
+
+// 段布局描述：几何参数与迁移所需字段的偏移（相对段起始或所在结构）
+// 迁移时只依据旧段中记录的描述读取条目，不需要旧版本的结构定义
+// 约定：key与state为int，in_use为bool，name/value/cold_tier_path以'\0'结尾
+// ks_active_table_offset为0表示只有一张表（版本5之前）；否则该处的int为活动表序号，
+// 各表从ks_hash_table_offset起连续存放
+struct SegmentLayout {
+  uint32_t hash_table_size;
+  uint32_t max_value_len;
+  uint32_t max_keyspaces;
+  uint32_t keyspace_name_len;
+  uint32_t cold_tier_path_len;
+  uint32_t ks_active_table_offset;
+  uint64_t keyspaces_offset;
+  uint64_t keyspace_stride;
+  uint64_t ks_in_use_offset;
+  uint64_t ks_name_offset;
+  uint64_t ks_table_mutex_offset;
+  uint64_t ks_hash_table_offset;
+  uint64_t ks_cold_tier_path_offset;
+  uint64_t ks_cold_tier_capacity_offset;
+  uint64_t entry_stride;
+  uint64_t entry_key_offset;
+  uint64_t entry_value_offset;
+  uint64_t entry_state_offset;
+  // 以下字段追加在末尾，0表示该段没有代数戳。至ks_history_offset为止头部不超过
+  // 192字节，旧段头部中对应位置是对齐填充（全0）
+  uint64_t ks_table_generation_offset;
+  uint64_t entry_generation_offset;
+  uint64_t ks_record_schema_offset; // 0表示该段不支持定长记录
+  uint64_t arena_offset;            // 0表示该段没有通用内存区
+  uint64_t arena_size;
+  uint64_t ks_history_offset; // 0表示该段不支持取值历史
+  // 版本10起头部增长到208字节，版本10之前的段中以下字段落在init_mutex上，
+  // 只在layout_version >= 10时有效
+  uint64_t entry_owner_offset; // uint16_t，0表示该段没有所有者标记
+  uint64_t ks_owner_tracking_offset;
+  // 版本12起：各键空间的功能开关（bool，采样率为int），用于迁移后恢复；
+  // 头部不超过256字节，init_mutex的位置与版本10、11相同
+  uint64_t ks_metrics_enabled_offset;
+  uint64_t ks_neg_filter_enabled_offset;
+  uint64_t ks_hot_keys_enabled_offset;
+  uint64_t ks_hot_keys_sample_rate_offset;
 };
 
+// 段头部位于偏移0，自身布局永不改变；initialized与未带头部的旧段位置相同，
+// 因此旧段也能被识别为"缺少头部"而不是无限等待
+struct SegmentHeader {
+  volatile uint32_t initialized;
+  uint32_t magic;
+  uint32_t layout_version;
+  uint32_t reserved;
+  uint64_t segment_size;
+  SegmentLayout layout;
+};
+
+static_assert(sizeof(SegmentHeader) <= 4 * CACHE_LINE_SIZE,
+              "growing the segment header further moves init_mutex");
+
 struct OptimizedSharedData {
-  volatile bool initialized;
-  int current_count;  // 实际使用的条目数
-  int deleted_count;  // 已删除的条目数
-  uint32_t hash_seed; // 哈希种子，用于防止哈希攻击
-  pthread_mutex_t table_mutex;
-  pthread_mutex_t init_mutex;
-  HashEntry hash_table[HASH_TABLE_SIZE];
+  alignas(CACHE_LINE_SIZE) SegmentHeader header; // 其余字段在attach时校验后才可访问
+  alignas(CACHE_LINE_SIZE) pthread_mutex_t init_mutex; // 同时保护键空间目录
+  KeyspaceData keyspaces[MAX_KEYSPACES]; // keyspaces[0]为默认键空间
+  alignas(CACHE_LINE_SIZE) OwnerRegistryData owners;
+  alignas(CACHE_LINE_SIZE) SharedArenaData arena;
 };
 
+class ColdTier;
+
 class OptimizedStatusRscManager : public ISharedMemoryManager {
 public:
   static OptimizedStatusRscManager &getInstance();
+  // 按名称获取键空间句柄，不存在则创建；目录已满时返回nullptr
+  // 所有键空间共享同一个映射，句柄由默认实例持有，调用者不得释放
+  static OptimizedStatusRscManager *getKeyspace(const std::string &name);
+  static int listKeyspaces(std::vector<std::string> &names);
+  // 段内通用内存区，所有进程共享；分配结果在各进程中地址不同，进程间传递须使用
+  // OffsetPtr（放在段内）或具名根
+  static SharedArena sharedArena();
 
   // Delete copy constructor and copy assignment
   OptimizedStatusRscManager(const OptimizedStatusRscManager &) = delete;
@@ -63,56 +302,283 @@ public:
   // 批量操作
   int batchUpdateRsc(const std::map<int, std::string> &updated_map) override;
   int batchGetRsc(std::map<int, std::string> &fetched_map) override;
+  int batchUpsertRsc(const std::map<int, std::string> &upserted_map) override;
 
   // 清理共享内存
   static int cleanup();
 
+  // 锁选项（实时场景）：须在getInstance()/getKeyspace()创建段或键空间之前设置
+  static void setLockOptions(const LockOptions &options);
+  static LockOptions lockOptions();
+
+  // 在线迁移：把旧布局版本的段转换为当前布局，保留所有键空间的条目与功能开关
+  // 迁移期间锁住旧段的table_mutex，旧版本进程的写操作会被阻塞，迁移后须重启
+  // 返回迁移的条目数（已是当前布局或段不存在时为0）；旧段无法读取，或通用内存区
+  // 大小不同且已有分配（无法保留）时不做任何修改并返回-1；有键空间无法重建或
+  // 恢复时返回IO_ERR，只有条目写入失败时返回NO_SPACE_ERR
+  static int migrate();
+
+  const char *keyspaceName() const { return ks_->name; }
+
+  // 热点键统计（默认关闭），对本键空间的所有进程生效
+  void setHotKeyTracking(bool enabled,
+                         int sample_rate = HOT_KEY_DEFAULT_SAMPLE_RATE);
+  int getHotKeys(HotKeyOp op, std::vector<HotKeyStat> &hot_keys,
+                 int limit = HOT_KEY_TOP_K);
+
+  // 启用冷热分层：冷条目降级到path指向的文件映射表，getRsc访问时自动提升
+  // 所有进程共享同一配置，启用后不可关闭；capacity须为2的幂次
+  int enableColdTier(const std::string &path,
+                     int capacity = COLD_TIER_DEFAULT_CAPACITY);
+
+  // 负查找过滤器（默认关闭）：启用后getRsc/isContain/updateRsc/removeRsc
+  // 对不存在的键大多无需加锁即可返回；启用时按现有内容重建
+  int setNegativeFilter(bool enabled);
+
+  // 整表替换：在非活动表中不加锁地构建contents，然后在table_mutex下一次切换，
+  // 读者只会看到旧表或新表；切换时冷数据层被清空，装载期间对旧表的写入随旧表一起丢弃
+  // 同一键空间同时只允许一个装载者。返回装载的条目数，超出热表容量返回NO_SPACE_ERR
+  int bulkRefresh(const std::map<int, std::string> &contents);
+
+  // 并行全表扫描（含冷数据层）：热表与冷层槽位视为一个区间，均分给threads个线程，
+  // 第i个线程写入parts[i]。线程在加锁前创建，table_mutex只在复制期间持有一次；
+  // sorted为true时解锁后各段并行排序再归并，parts只保留一段。返回条目总数
+  int parallelScan(int threads, std::vector<ScanArena> &parts,
+                   bool sorted = false);
+
+  // 只读快照：经parallelScan复制全表（含冷数据层，table_mutex只在复制期间持有一次），
+  // 在锁外写入加封的memfd。返回fd，可经SCM_RIGHTS传给其他进程，由调用者关闭；失败返回-1
+  int publishSnapshot(int threads = 1);
+  // 同时以name登记，其他进程用SnapshotView::openNamed(sharedArena(), name)打开
+  int publishSnapshot(const std::string &name, int threads = 1);
+
+  // 定长记录：注册后条目保存打包的二进制记录，字符串写接口返回-1，
+  // getRsc/batchGetRsc返回原始记录字节；不能与冷数据层同时使用。
+  // 须在写入前注册；各进程以相同布局重复注册返回OK，表非空时不能更换布局
+  int setRecordSchema(const std::vector<RecordField> &fields);
+  int recordSize() const { return RecordSchema(&ks_->record_schema).recordSize(); }
+  // 字段序号，不存在返回-1；热路径应预先解析一次
+  int recordFieldIndex(const std::string &name) const {
+    return RecordSchema(&ks_->record_schema).fieldIndex(name);
+  }
+  // 整条记录：record指向recordSize()字节；putRecord插入或覆盖
+  int putRecord(int key, const void *record);
+  int getRecord(int key, void *record);
+  // 单个字段：在一次持锁内完成，字段序号或类型不符返回-1，键不存在返回NOT_FOUND
+  int getField(int key, int field, int64_t *value);
+  int getField(int key, int field, double *value);
+  int getField(int key, int field, std::string *value);
+  int setField(int key, int field, int64_t value);
+  int setField(int key, int field, double value);
+  int setField(int key, int field, const std::string &value);
+  // 整数字段原子加delta，result返回加后的值
+  int addField(int key, int field, int64_t delta, int64_t *result = nullptr);
+
+  // 取值历史（默认关闭）：启用后每次成功的写操作在该键的环中追加(时间戳, 值)，
+  // 每个键保留最近depth条，超过value_len字节的值被截断；定长记录保存整条记录。
+  // 存储从通用内存区分配，空间不足返回NO_SPACE_ERR，已按其他参数启用时返回-1。
+  // removeRsc丢弃该键的历史，clearRsc与bulkRefresh清空全部历史
+  int setValueHistory(bool enabled, int depth = HISTORY_DEFAULT_DEPTH,
+                      int value_len = HISTORY_DEFAULT_VALUE_LEN);
+  // 从新到旧返回最多limit条（<=0表示全部）；未启用返回-1，键无历史返回NOT_FOUND
+  int getHistory(int key, std::vector<HistoryEntry> &entries, int limit = 0);
+
+  // 异步环：在一次持锁内按顺序执行count个提交，completions[i]对应submissions[i]。
+  // 设置了max_batch_per_lock时每执行这么多项让出一次锁，其他写者可能插在批次中间。
+  // 返回执行数
+  int applySubmissions(const RingSubmission *submissions, int count,
+                       RingCompletion *completions);
+
+  // 所有者标记（默认关闭）：启用后本键空间的每次写入把条目标记为写入进程所有。
+  // 进程退出后，其他进程的写操作顺带回收它的条目（每次最多OWNER_RECLAIM_BATCH条），
+  // 按所有者链表直接定位，无需扫描全表。不能与冷数据层同时使用；启用后不可关闭，
+  // 启用前写入的条目保持无主，迁移后的条目同样无主
+  int enableOwnerTracking();
+  // 检查所有登记进程的存活并一次回收本键空间中已退出进程的全部条目，返回回收数；
+  // 供长时间没有写入的键空间使用
+  int reclaimDeadOwners();
+  uint64_t reclaimedEntries() const { return ks_->owner_reclaimed; }
+
+  // 运行时统计：无锁读取所有分片之和，供OpenMetrics导出使用。
+  // 默认关闭，关闭时公开操作与加锁都不读取时钟；metrics_daemon运行时为各键空间开启
+  void setMetricsEnabled(bool enabled);
+  void collectMetrics(KeyspaceMetrics &metrics) const;
+  void recordOp(OpStatType op, uint64_t latency_ns);
+
+  // 哈希种子代数，重新选种后递增；所有进程从段内读取种子，无需额外同步
+  uint32_t seedGeneration() const {
+    return ks_->seed_generation.load(std::memory_order_acquire);
+  }
+
 private:
+  friend struct std::default_delete<OptimizedStatusRscManager>;
+
   OptimizedStatusRscManager();
+  OptimizedStatusRscManager(OptimizedSharedData *shared_data,
+                            KeyspaceData *keyspace);
   ~OptimizedStatusRscManager();
 
+  // 段头部：创建时写入，attach时校验，不兼容时返回原因
+  static SegmentLayout currentLayout();
+  static void initSegmentHeader(SegmentHeader *header);
+  static std::string checkSegmentHeader(const SegmentHeader &header,
+                                        size_t segment_size);
+
+  void initKeyspace(KeyspaceData *keyspace, const std::string &name);
+  KeyspaceData *findOrCreateKeyspace(const std::string &name);
+
   // 哈希函数相关
   uint32_t hash(int key) const;
   uint32_t hash2(int key) const; // 双重哈希的第二个哈希函数
+  static uint32_t hashWithSeed(int key, uint32_t seed);
+  static uint32_t hash2WithSeed(int key, uint32_t seed);
+
+  // 当前活动表，调用者持有table_mutex
+  HashEntry *table() const {
+    return ks_->hash_tables[ks_->active_table.load(std::memory_order_relaxed)];
+  }
+
+  // table_mutex加解锁，附带USDT锁探针
+  void lockTable();
+  void unlockTable();
+  // 批量操作中每完成一项调用一次，达到max_batch_per_lock时释放并重新获取锁
+  bool yieldTableIfNeeded(int &work_in_section);
 
   // 内部辅助函数（不加锁）
+  // 批量路径预先算好hash2_val，两参数版本现场计算
   int findEntry(int key, uint32_t hash_val);
-  int findEmptySlot(int key, uint32_t hash_val);
+  int findEntry(int key, uint32_t hash_val, uint32_t hash2_val);
+  int findEmptySlot(int key, uint32_t hash_val, int *probes = nullptr);
+  int findEmptySlot(int key, uint32_t hash_val, uint32_t hash2_val,
+                    int *probes = nullptr);
+  // 代数戳清空：条目代数与表的当前代数不同时按空槽处理，下次写入时就地回收
+  uint32_t tableGeneration() const {
+    return ks_->table_generation[ks_->active_table.load(std::memory_order_relaxed)];
+  }
+  static EntryState liveState(const HashEntry &entry, uint32_t generation) {
+    return entry.generation == generation ? entry.state : EMPTY;
+  }
+  void advanceGeneration(int table_index);
   bool needRehash() const;
   int rehashIfNeeded();
+  int rehashLocked();
+  bool shouldReseed(int insert_probes);
+  int reseedLocked();
+  int insertLocked(int key, const char *value, uint32_t hash_val);
+  int insertLocked(int key, const char *value, uint32_t hash_val,
+                   uint32_t hash2_val);
+  // 单键操作的持锁部分，同步接口与applySubmissions共用；参数检查由调用者完成
+  int addLocked(int key, const char *value, uint32_t hash_val);
+  int updateLocked(int key, const char *value, uint32_t hash_val);
+  int upsertLocked(int key, const char *value, uint32_t hash_val);
+  int removeLocked(int key, uint32_t hash_val);
+  bool containsLocked(int key, uint32_t hash_val);
+  // 值复制到value（MAX_VALUE_LEN字节），返回长度；不存在时返回NOT_FOUND
+  int getLocked(int key, uint32_t hash_val, char *value);
+
+  // 冷热分层（调用者持有table_mutex，coldTier()除外）
+  ColdTier *coldTier();
+  int demoteColdEntries(int keep_key);
+  void promoteLocked(int key, const char *value, uint32_t hash_val,
+                     ColdTier *cold);
+
+  // 定长记录：lockRecord成功时返回OK并保持table_mutex，record指向条目中的记录
+  RecordSchema recordSchema() const { return RecordSchema(&ks_->record_schema); }
+  int lockRecord(int key, char **record);
+  // lockRecord返回的记录所在的槽位
+  int recordSlot(const char *record) const {
+    return static_cast<int>(reinterpret_cast<const HashEntry *>(
+                                record - offsetof(HashEntry, value)) -
+                            table());
+  }
+  void storeValue(char *dest, const char *value) const;
+  // 持锁期间由扫描线程调用，复制槽位[begin, end)中的条目
+  void scanRange(ScanArena &out, int begin, int end, ColdTier *cold,
+                 uint32_t generation) const;
+  std::string loadValue(const char *value) const;
+
+  // 取值历史（调用者持有table_mutex），未启用时historyData()返回nullptr
+  ValueHistoryData *historyData() const;
+  // 写操作成功后调用，value为刚写入的值
+  void recordHistory(int key, const char *value);
+
+  // 所有者标记（调用者持有table_mutex）
+  OwnerRegistry owners() const { return OwnerRegistry(&shared_data_->owners); }
+  int keyspaceIndex() const {
+    return static_cast<int>(ks_ - shared_data_->keyspaces);
+  }
+  void linkOwner(int pos, uint16_t owner);
+  void unlinkOwner(int pos);
+  // 清空表后调用：各链表置空并注销所有者在本键空间的标记
+  void resetOwnerLists();
+  // 条目移动后按标记重建链表，不改变条目的所有者
+  void rebuildOwnerLists();
+  // 写入table()[pos]后调用：改标为本进程，并顺带检查存活、回收已退出进程的条目
+  void ownWriteLocked(int pos);
+  int reclaimDeadLocked(int limit);
+
+  HotKeyTracker hotKeys() const { return HotKeyTracker(&ks_->hot_keys); }
+  NegativeFilter negFilter() const { return NegativeFilter(&ks_->neg_filter); }
+  // 无锁判断键是否一定不存在
+  bool filteredMiss(int key);
+
+  void recordProbes(int probes);
+
+  // 分片计数器，读取时对所有分片求和
+  int currentCount() const;
+  int deletedCount() const;
+  void adjustCounts(int current_delta, int deleted_delta);
+  // 调用者持有table_mutex；有效条目数一次发布，单个分片可能为负
+  void setCurrentCount(int count);
+  void resetDeletedCounts();
 
   // 探测序列生成
   int getNextProbe(int current_pos, int step, uint32_t hash2_val) const;
 
 private:
   OptimizedSharedData *shared_data_;
-  int shm_fd_;
+  KeyspaceData *ks_; // 本句柄操作的键空间
+  int shm_fd_;       // 仅映射的持有者（默认实例）有效
   bool is_creator_;
+  std::atomic<ColdTier *> cold_tier_; // 本进程打开的冷数据层，延迟打开
+
+  // 默认实例持有的其他键空间句柄
+  std::map<std::string, std::unique_ptr<OptimizedStatusRscManager>>
+      keyspace_handles_;
+  std::mutex handles_mutex_;
 };
 
 // 内联哈希函数实现
 inline uint32_t OptimizedStatusRscManager::hash(int key) const {
-  // MurmurHash3的简化版本，针对32位整数优化
-  uint32_t k = static_cast<uint32_t>(key);
-  k ^= shared_data_->hash_seed;
-  k ^= k >> 16;
-  k *= 0x85ebca6b;
-  k ^= k >> 13;
-  k *= 0xc2b2ae35;
-  k ^= k >> 16;
-  return k & (HASH_TABLE_SIZE - 1); // 使用位运算代替模运算
+  return hashWithSeed(key, ks_->hash_seed);
 }
 
 inline uint32_t OptimizedStatusRscManager::hash2(int key) const {
+  return hash2WithSeed(key, ks_->hash_seed);
+}
+
+inline uint32_t OptimizedStatusRscManager::hashWithSeed(int key, uint32_t seed) {
+  // MurmurHash3的简化版本，针对32位整数优化
+  return murmurMix1(key, seed) & (HASH_TABLE_SIZE - 1); // 使用位运算代替模运算
+}
+
+inline uint32_t OptimizedStatusRscManager::hash2WithSeed(int key, uint32_t seed) {
   // 第二个哈希函数，用于双重哈希
-  uint32_t k = static_cast<uint32_t>(key);
-  k ^= shared_data_->hash_seed + 0x9e3779b9;
-  k ^= k >> 16;
-  k *= 0x21f0aaad;
-  k ^= k >> 15;
-  k *= 0x735a2d97;
-  k ^= k >> 15;
-  return (k & (HASH_TABLE_SIZE - 1)) | 1; // 确保结果是奇数
+  return (murmurMix2(key, seed) & (HASH_TABLE_SIZE - 1)) | 1; // 确保结果是奇数
+}
+
+inline int OptimizedStatusRscManager::findEntry(int key, uint32_t hash_val) {
+  return findEntry(key, hash_val, hash2(key));
+}
+
+inline int OptimizedStatusRscManager::findEmptySlot(int key, uint32_t hash_val,
+                                                    int *probes) {
+  return findEmptySlot(key, hash_val, hash2(key), probes);
+}
+
+inline int OptimizedStatusRscManager::insertLocked(int key, const char *value,
+                                                   uint32_t hash_val) {
+  return insertLocked(key, value, hash_val, hash2(key));
 }
 
 inline int OptimizedStatusRscManager::getNextProbe(int current_pos, int step,
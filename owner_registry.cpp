@@ -0,0 +1,149 @@
+#include "owner_registry.h"
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+// 本进程的登记结果；段被重建或fork后由self()校验发现失效
+std::mutex g_self_mutex;
+std::atomic<uint32_t> g_self_owner(0);
+
+} // namespace
+
+uint64_t OwnerRegistry::processStartTime(int pid) {
+    std::string path = "/proc/" + std::to_string(pid) + "/stat";
+    FILE *file = fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return 0;
+    }
+    char buffer[1024];
+    size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+    fclose(file);
+    buffer[length] = '\0';
+
+    // 第2个字段是括号中的进程名，可能含空格；从最后一个')'之后开始数，starttime是第22个字段
+    const char *cursor = strrchr(buffer, ')');
+    if (cursor == nullptr) {
+        return 0;
+    }
+    for (int field = 2; field < 22 && cursor != nullptr; ++field) {
+        cursor = strchr(cursor + 1, ' ');
+    }
+    return cursor != nullptr ? strtoull(cursor + 1, nullptr, 10) : 0;
+}
+
+bool OwnerRegistry::processAlive(int pid, uint64_t start_time) {
+    if (kill(pid, 0) != 0 && errno == ESRCH) {
+        return false;
+    }
+    // pid仍存在时比对启动时刻，识别pid复用
+    uint64_t current = start_time != 0 ? processStartTime(pid) : 0;
+    return current == 0 || current == start_time;
+}
+
+void OwnerRegistry::init(OwnerRegistryData *data) {
+    data->check_hand.store(0, std::memory_order_relaxed);
+    data->dead_count.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < MAX_OWNERS; ++i) {
+        data->slots[i].state.store(OWNER_FREE, std::memory_order_relaxed);
+        data->slots[i].keyspace_mask.store(0, std::memory_order_relaxed);
+        data->slots[i].pid.store(0, std::memory_order_relaxed);
+        data->slots[i].start_time.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint16_t OwnerRegistry::self() {
+    int pid = static_cast<int>(getpid());
+    uint32_t cached = g_self_owner.load(std::memory_order_acquire);
+    if (cached != 0 && slot(cached).pid.load(std::memory_order_relaxed) == pid &&
+        slot(cached).state.load(std::memory_order_acquire) == OWNER_LIVE) {
+        return static_cast<uint16_t>(cached);
+    }
+
+    std::lock_guard<std::mutex> guard(g_self_mutex);
+    cached = g_self_owner.load(std::memory_order_relaxed);
+    if (cached != 0 && slot(cached).pid.load(std::memory_order_relaxed) == pid &&
+        slot(cached).state.load(std::memory_order_acquire) == OWNER_LIVE) {
+        return static_cast<uint16_t>(cached);
+    }
+    uint64_t start_time = processStartTime(pid);
+    for (int owner = 1; owner <= MAX_OWNERS; ++owner) {
+        OwnerSlot &candidate = slot(owner);
+        uint32_t expected = OWNER_FREE;
+        if (!candidate.state.compare_exchange_strong(expected, OWNER_CLAIMING)) {
+            continue;
+        }
+        candidate.keyspace_mask.store(0, std::memory_order_relaxed);
+        candidate.pid.store(pid, std::memory_order_relaxed);
+        candidate.start_time.store(start_time, std::memory_order_relaxed);
+        candidate.state.store(OWNER_LIVE, std::memory_order_release);
+        g_self_owner.store(owner, std::memory_order_release);
+        return static_cast<uint16_t>(owner);
+    }
+    return 0;
+}
+
+bool OwnerRegistry::alive(const OwnerSlot &slot) const {
+    return processAlive(slot.pid.load(std::memory_order_relaxed),
+                        slot.start_time.load(std::memory_order_relaxed));
+}
+
+int OwnerRegistry::checkLiveness(int count) {
+    int limit = count > 0 ? count : MAX_OWNERS;
+    int checked = 0;
+    int marked = 0;
+    // 最多走一圈，空闲槽位不计入count
+    for (int visited = 0; visited < MAX_OWNERS && checked < limit; ++visited) {
+        uint32_t index = data_->check_hand.fetch_add(1, std::memory_order_relaxed) % MAX_OWNERS;
+        OwnerSlot &candidate = data_->slots[index];
+        // 只检查LIVE：登记或释放中途（CLAIMING）的槽位随后会改变状态
+        uint32_t state = candidate.state.load(std::memory_order_acquire);
+        if (state != OWNER_LIVE) {
+            continue;
+        }
+        checked++;
+        if (alive(candidate)) {
+            continue;
+        }
+        if (!candidate.state.compare_exchange_strong(state, OWNER_DEAD)) {
+            continue;
+        }
+        data_->dead_count.fetch_add(1, std::memory_order_release);
+        marked++;
+        if (candidate.keyspace_mask.load(std::memory_order_acquire) == 0) {
+            release(static_cast<uint16_t>(index + 1));
+        }
+    }
+    return marked;
+}
+
+void OwnerRegistry::markKeyspace(uint16_t owner, int keyspace_index) {
+    slot(owner).keyspace_mask.fetch_or(1u << keyspace_index, std::memory_order_acq_rel);
+}
+
+void OwnerRegistry::unmarkKeyspace(uint16_t owner, int keyspace_index) {
+    OwnerSlot &target = slot(owner);
+    uint32_t bit = 1u << keyspace_index;
+    uint32_t previous = target.keyspace_mask.fetch_and(~bit, std::memory_order_acq_rel);
+    if ((previous & ~bit) == 0 && target.state.load(std::memory_order_acquire) == OWNER_DEAD) {
+        release(owner);
+    }
+}
+
+void OwnerRegistry::release(uint16_t owner) {
+    // DEAD到FREE只发生一次；已退出的进程不会再写入，mask此后保持为0
+    OwnerSlot &target = slot(owner);
+    uint32_t expected = OWNER_DEAD;
+    if (target.state.compare_exchange_strong(expected, OWNER_CLAIMING)) {
+        target.pid.store(0, std::memory_order_relaxed);
+        target.start_time.store(0, std::memory_order_relaxed);
+        target.state.store(OWNER_FREE, std::memory_order_release);
+        data_->dead_count.fetch_sub(1, std::memory_order_release);
+    }
+}
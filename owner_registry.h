@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 进程存活登记表：写入进程登记后获得一个编号，条目以编号标记所有者。
+// 存活检查使用kill(pid, 0)并比对进程启动时刻（/proc/<pid>/stat中的starttime），
+// pid被复用时同样视为已退出。编号只在该进程的条目全部回收后才会重新分配
+const int MAX_OWNERS = 256; // 编号1..MAX_OWNERS，0表示无主
+
+enum OwnerState {
+  OWNER_FREE = 0,
+  OWNER_CLAIMING = 1, // 正在登记
+  OWNER_LIVE = 2,
+  OWNER_DEAD = 3 // 已退出，条目回收中
+};
+
+struct OwnerSlot {
+  std::atomic<uint32_t> state;
+  // 该编号在哪些键空间中仍有条目（按键空间序号的位图），全部回收后释放编号
+  std::atomic<uint32_t> keyspace_mask;
+  std::atomic<int> pid;
+  std::atomic<uint64_t> start_time;
+};
+
+struct OwnerRegistryData {
+  std::atomic<uint32_t> check_hand; // 轮转检查的下一个槽位
+  std::atomic<uint32_t> dead_count; // DEAD状态的槽位数，为0时写者无需回收
+  OwnerSlot slots[MAX_OWNERS];
+};
+
+// 共享内存中OwnerRegistryData的无状态访问器，所有操作无锁
+class OwnerRegistry {
+public:
+  explicit OwnerRegistry(OwnerRegistryData *data) : data_(data) {}
+
+  static void init(OwnerRegistryData *data);
+
+  // 进程启动时刻（自系统启动的时钟滴答数），无法读取时返回0
+  static uint64_t processStartTime(int pid);
+  // pid已不存在或启动时刻与start_time不符（pid被复用）时返回false；
+  // start_time为0时只检查pid
+  static bool processAlive(int pid, uint64_t start_time);
+
+  // 本进程的编号，首次调用时登记（fork出的子进程重新登记）；登记表已满返回0
+  uint16_t self();
+
+  // 从check_hand起检查最多count个已登记的槽位（count<=0表示全部），
+  // 已退出的标记为DEAD，返回新标记的数量
+  int checkLiveness(int count);
+
+  bool hasDead() const {
+    return data_->dead_count.load(std::memory_order_acquire) != 0;
+  }
+  bool isDead(uint16_t owner) const {
+    return slot(owner).state.load(std::memory_order_acquire) == OWNER_DEAD;
+  }
+
+  // 调用者持有对应键空间的table_mutex：所有者在该键空间的条目由无变有时mark，
+  // 由有变无时unmark；DEAD编号在所有键空间都unmark后释放
+  void markKeyspace(uint16_t owner, int keyspace_index);
+  void unmarkKeyspace(uint16_t owner, int keyspace_index);
+
+  int pidOf(uint16_t owner) const {
+    return slot(owner).pid.load(std::memory_order_relaxed);
+  }
+
+private:
+  OwnerSlot &slot(uint16_t owner) const { return data_->slots[owner - 1]; }
+  bool alive(const OwnerSlot &slot) const;
+  void release(uint16_t owner);
+
+private:
+  OwnerRegistryData *data_;
+};
@@ -0,0 +1,209 @@
+#include "record_schema.h"
+#include "optimized_status.h"
+#include <cstring>
+#include <set>
+
+namespace {
+
+int fieldSize(RecordFieldType type) {
+    switch (type) {
+    case FIELD_INT32:
+    case FIELD_UINT32:
+        return 4;
+    case FIELD_INT64:
+    case FIELD_UINT64:
+    case FIELD_DOUBLE:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+} // namespace
+
+void RecordSchema::init(RecordSchemaData *data) {
+    data->field_count.store(0, std::memory_order_relaxed);
+    data->record_size = 0;
+    memset(data->fields, 0, sizeof(data->fields));
+}
+
+int RecordSchema::build(const std::vector<RecordField> &fields, int max_size,
+                        RecordSchemaData *out) {
+    if (fields.empty() || fields.size() > static_cast<size_t>(MAX_RECORD_FIELDS)) {
+        return -1;
+    }
+
+    std::set<std::string> names;
+    int offset = 0;
+    for (size_t i = 0; i < fields.size(); ++i) {
+        const RecordField &field = fields[i];
+        if (field.name.empty() || field.name.length() >= RECORD_FIELD_NAME_LEN ||
+            !names.insert(field.name).second) {
+            return -1;
+        }
+
+        int size = field.type == FIELD_CHARS ? field.size : fieldSize(field.type);
+        if (size <= 0 || (field.type != FIELD_CHARS && field.size != 0)) {
+            return -1;
+        }
+        int align = field.type == FIELD_CHARS ? 1 : size;
+        offset = (offset + align - 1) & ~(align - 1);
+        if (offset + size > max_size) {
+            return NO_SPACE_ERR;
+        }
+
+        RecordFieldSlot &slot = out->fields[i];
+        memset(&slot, 0, sizeof(slot));
+        strncpy(slot.name, field.name.c_str(), RECORD_FIELD_NAME_LEN - 1);
+        slot.type = field.type;
+        slot.offset = static_cast<uint16_t>(offset);
+        slot.size = static_cast<uint16_t>(size);
+        offset += size;
+    }
+
+    int record_size = (offset + 7) & ~7;
+    if (record_size > max_size) {
+        return NO_SPACE_ERR;
+    }
+    out->record_size = record_size;
+    out->field_count.store(static_cast<int>(fields.size()), std::memory_order_relaxed);
+    return OK;
+}
+
+int RecordSchema::fieldIndex(const std::string &name) const {
+    int count = fieldCount();
+    for (int i = 0; i < count; ++i) {
+        if (name == data_->fields[i].name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool RecordSchema::sameAs(const RecordSchemaData &other) const {
+    int count = fieldCount();
+    return count == other.field_count.load(std::memory_order_relaxed) &&
+           data_->record_size == other.record_size &&
+           memcmp(data_->fields, other.fields, sizeof(RecordFieldSlot) * count) == 0;
+}
+
+void RecordSchema::assign(const RecordSchemaData &other) {
+    // 先撤下旧布局，写完字段后再发布字段数
+    data_->field_count.store(0, std::memory_order_release);
+    data_->record_size = other.record_size;
+    memcpy(data_->fields, other.fields, sizeof(data_->fields));
+    data_->field_count.store(other.field_count.load(std::memory_order_relaxed),
+                             std::memory_order_release);
+}
+
+const RecordFieldSlot *RecordSchema::slot(int field, bool numeric) const {
+    if (field < 0 || field >= fieldCount()) {
+        return nullptr;
+    }
+    const RecordFieldSlot *result = &data_->fields[field];
+    if (numeric != (result->type != FIELD_CHARS) ||
+        (numeric && result->type == FIELD_DOUBLE)) {
+        return nullptr;
+    }
+    return result;
+}
+
+int RecordSchema::readInt(const char *record, int field, int64_t *value) const {
+    const RecordFieldSlot *s = slot(field, true);
+    if (s == nullptr) {
+        return -1;
+    }
+    const char *p = record + s->offset;
+    switch (s->type) {
+    case FIELD_INT32: {
+        int32_t v;
+        memcpy(&v, p, sizeof(v));
+        *value = v;
+        break;
+    }
+    case FIELD_UINT32: {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        *value = v;
+        break;
+    }
+    default: {
+        // INT64与UINT64按位保存，UINT64超过INT64_MAX的值以补码形式返回
+        int64_t v;
+        memcpy(&v, p, sizeof(v));
+        *value = v;
+        break;
+    }
+    }
+    return OK;
+}
+
+int RecordSchema::writeInt(char *record, int field, int64_t value) const {
+    const RecordFieldSlot *s = slot(field, true);
+    if (s == nullptr) {
+        return -1;
+    }
+    char *p = record + s->offset;
+    if (s->size == 4) {
+        uint32_t v = static_cast<uint32_t>(value);
+        memcpy(p, &v, sizeof(v));
+    } else {
+        memcpy(p, &value, sizeof(value));
+    }
+    return OK;
+}
+
+int RecordSchema::addInt(char *record, int field, int64_t delta, int64_t *result) const {
+    int64_t value;
+    int ret = readInt(record, field, &value);
+    if (ret != OK) {
+        return ret;
+    }
+    value = static_cast<int64_t>(static_cast<uint64_t>(value) + static_cast<uint64_t>(delta));
+    writeInt(record, field, value);
+    if (result != nullptr) {
+        // 32位字段按字段类型回绕后的值返回
+        readInt(record, field, result);
+    }
+    return OK;
+}
+
+int RecordSchema::readDouble(const char *record, int field, double *value) const {
+    if (field < 0 || field >= fieldCount() || data_->fields[field].type != FIELD_DOUBLE) {
+        return -1;
+    }
+    memcpy(value, record + data_->fields[field].offset, sizeof(*value));
+    return OK;
+}
+
+int RecordSchema::writeDouble(char *record, int field, double value) const {
+    if (field < 0 || field >= fieldCount() || data_->fields[field].type != FIELD_DOUBLE) {
+        return -1;
+    }
+    memcpy(record + data_->fields[field].offset, &value, sizeof(value));
+    return OK;
+}
+
+int RecordSchema::readChars(const char *record, int field, std::string *value) const {
+    const RecordFieldSlot *s = slot(field, false);
+    if (s == nullptr) {
+        return -1;
+    }
+    const char *p = record + s->offset;
+    value->assign(p, strnlen(p, s->size));
+    return OK;
+}
+
+int RecordSchema::writeChars(char *record, int field, const std::string &value) const {
+    const RecordFieldSlot *s = slot(field, false);
+    if (s == nullptr) {
+        return -1;
+    }
+    if (value.length() >= s->size) {
+        return NO_SPACE_ERR;
+    }
+    char *p = record + s->offset;
+    memset(p, 0, s->size);
+    memcpy(p, value.data(), value.length());
+    return OK;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 定长记录：键空间可注册一个字段布局，条目值保存打包后的二进制记录，
+// 读写单个字段时无需解析和格式化整个字符串
+const int MAX_RECORD_FIELDS = 16;
+const int RECORD_FIELD_NAME_LEN = 24;
+
+enum RecordFieldType : uint8_t {
+  FIELD_INT32 = 1,
+  FIELD_UINT32,
+  FIELD_INT64,
+  FIELD_UINT64,
+  FIELD_DOUBLE,
+  FIELD_CHARS, // 定长字符数组，以'\0'结尾
+};
+
+// 注册布局时的字段描述
+struct RecordField {
+  RecordField(const std::string &name, RecordFieldType type, int size = 0)
+      : name(name), type(type), size(size) {}
+
+  std::string name;
+  RecordFieldType type;
+  int size; // 仅FIELD_CHARS使用：容量，含结尾'\0'
+};
+
+// 共享内存中的字段描述与布局；与段头部一样，自身布局不随段版本改变，迁移时按原样复制
+struct RecordFieldSlot {
+  char name[RECORD_FIELD_NAME_LEN];
+  uint8_t type;
+  uint8_t reserved;
+  uint16_t offset; // 数值字段按自身大小对齐
+  uint16_t size;
+};
+
+struct RecordSchemaData {
+  std::atomic<int> field_count; // 0表示普通字符串键空间；字段写完后才发布
+  int record_size;              // 按8字节取整
+  RecordFieldSlot fields[MAX_RECORD_FIELDS];
+};
+
+// 共享内存中RecordSchemaData的无状态访问器
+// 修改布局以及读写记录都要求调用者持有table_mutex，因此单个字段的更新对其他进程是原子的
+class RecordSchema {
+public:
+  explicit RecordSchema(RecordSchemaData *data) : data_(data) {}
+
+  static void init(RecordSchemaData *data);
+  // 按字段顺序计算布局，字段非法返回-1，记录超过max_size返回NO_SPACE_ERR
+  static int build(const std::vector<RecordField> &fields, int max_size,
+                   RecordSchemaData *out);
+
+  bool enabled() const {
+    return data_->field_count.load(std::memory_order_acquire) > 0;
+  }
+  int recordSize() const { return enabled() ? data_->record_size : 0; }
+  int fieldCount() const {
+    return data_->field_count.load(std::memory_order_acquire);
+  }
+  int fieldIndex(const std::string &name) const;
+
+  bool sameAs(const RecordSchemaData &other) const;
+  void assign(const RecordSchemaData &other);
+
+  // 字段读写，record指向条目中的记录；字段序号或类型不符返回-1
+  int readInt(const char *record, int field, int64_t *value) const;
+  int readDouble(const char *record, int field, double *value) const;
+  int readChars(const char *record, int field, std::string *value) const;
+  int writeInt(char *record, int field, int64_t value) const;
+  int writeDouble(char *record, int field, double value) const;
+  // 超过字段容量返回NO_SPACE_ERR
+  int writeChars(char *record, int field, const std::string &value) const;
+  int addInt(char *record, int field, int64_t delta, int64_t *result) const;
+
+private:
+  const RecordFieldSlot *slot(int field, bool numeric) const;
+
+private:
+  RecordSchemaData *data_;
+};
@@ -0,0 +1,193 @@
+/*
+ * 实时读者延迟基准
+ * SCHED_FIFO读者周期性执行getRsc，同时后台低优先级进程反复执行批量写入和批量读取，
+ * 可选再加一个中等优先级的CPU占用进程制造优先级反转。所有进程绑定到同一个CPU。
+ * 运行: ./rt_latency_bench [-p] [-c max_batch_per_lock] [-m] [-d seconds]
+ *   -p  使用优先级继承锁（独立的"rt_pi"键空间，否则使用"rt_plain"）
+ *   -c  批量操作单次持锁处理的最大条目数
+ *   -m  启动中等优先级的CPU占用进程
+ * 设置SCHED_FIFO需要CAP_SYS_NICE，失败时以普通优先级继续运行。
+ */
+
+#include "optimized_status.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const int BULK_KEYS = 1024;
+const int READER_PRIORITY = 80;
+const int HOG_PRIORITY = 40;
+const int READER_PERIOD_US = 200;
+const int HOG_SPIN_MS = 20;
+
+void pinToCpu(int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  sched_setaffinity(0, sizeof(set), &set);
+}
+
+bool setFifo(int priority) {
+  sched_param param;
+  memset(&param, 0, sizeof(param));
+  param.sched_priority = priority;
+  return sched_setscheduler(0, SCHED_FIFO, &param) == 0;
+}
+
+double percentile(std::vector<double> &sorted, double p) {
+  size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+  return sorted[index];
+}
+
+// 后台批量进程：反复整批写入并整表读取，制造长临界区
+void runBulkWorker(OptimizedStatusRscManager *manager,
+                   std::atomic<bool> *stop) {
+  setpriority(PRIO_PROCESS, 0, 19);
+  std::map<int, std::string> batch;
+  for (int i = 0; i < BULK_KEYS; ++i) {
+    batch[i] = "bulk";
+  }
+  std::map<int, std::string> fetched;
+  while (!stop->load()) {
+    manager->batchUpsertRsc(batch);
+    manager->batchGetRsc(fetched);
+  }
+}
+
+// 中等优先级占用进程：抢占未继承优先级的持锁者
+// 每忙等HOG_SPIN_MS休眠1ms，并在测试结束时自行退出，保证反转有界、测试能够结束
+void runHog(std::atomic<bool> *stop,
+            std::chrono::steady_clock::time_point deadline) {
+  if (!setFifo(HOG_PRIORITY)) {
+    return;
+  }
+  while (!stop->load() && std::chrono::steady_clock::now() < deadline) {
+    auto burst_end = std::chrono::steady_clock::now() +
+                     std::chrono::milliseconds(HOG_SPIN_MS);
+    while (std::chrono::steady_clock::now() < burst_end) {
+    }
+    usleep(1000);
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  LockOptions options;
+  bool hog = false;
+  int seconds = 3;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "pc:md:")) != -1) {
+    switch (opt) {
+    case 'p':
+      options.priority_inherit = true;
+      break;
+    case 'c':
+      options.max_batch_per_lock = std::atoi(optarg);
+      break;
+    case 'm':
+      hog = true;
+      break;
+    case 'd':
+      seconds = std::atoi(optarg);
+      break;
+    default:
+      std::cerr << "Usage: " << argv[0]
+                << " [-p] [-c max_batch_per_lock] [-m] [-d seconds]"
+                << std::endl;
+      return 2;
+    }
+  }
+
+  OptimizedStatusRscManager::setLockOptions(options);
+  OptimizedStatusRscManager *manager = OptimizedStatusRscManager::getKeyspace(
+      options.priority_inherit ? "rt_pi" : "rt_plain");
+  if (manager == nullptr) {
+    std::cerr << "Failed to get keyspace" << std::endl;
+    return 1;
+  }
+  manager->clearRsc();
+  manager->addRsc(-1, "control");
+
+  std::cout << "=== RT Latency Bench (priority inheritance "
+            << (options.priority_inherit ? "on" : "off")
+            << ", max_batch_per_lock " << options.max_batch_per_lock
+            << (hog ? ", medium-priority hog" : "") << ") ===" << std::endl;
+
+  void *mapped = mmap(nullptr, sizeof(std::atomic<bool>),
+                      PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (mapped == MAP_FAILED) {
+    std::cerr << "mmap failed: " << strerror(errno) << std::endl;
+    return 1;
+  }
+  std::atomic<bool> *stop = new (mapped) std::atomic<bool>(false);
+
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+
+  pinToCpu(0);
+  std::vector<pid_t> children;
+  pid_t pid = fork();
+  if (pid == 0) {
+    runBulkWorker(manager, stop);
+    _exit(0);
+  }
+  children.push_back(pid);
+  if (hog) {
+    pid = fork();
+    if (pid == 0) {
+      runHog(stop, deadline);
+      _exit(0);
+    }
+    children.push_back(pid);
+  }
+
+  if (!setFifo(READER_PRIORITY)) {
+    std::cerr << "SCHED_FIFO unavailable (" << strerror(errno)
+              << "), reader runs at normal priority" << std::endl;
+  }
+
+  std::vector<double> latencies_us;
+  while (std::chrono::steady_clock::now() < deadline) {
+    auto start = std::chrono::steady_clock::now();
+    manager->getRsc(-1);
+    latencies_us.push_back(std::chrono::duration<double, std::micro>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
+    usleep(READER_PERIOD_US);
+  }
+
+  // 恢复普通优先级后再等待子进程，避免与占用进程互相阻塞
+  sched_param param;
+  memset(&param, 0, sizeof(param));
+  sched_setscheduler(0, SCHED_OTHER, &param);
+  stop->store(true);
+  for (pid_t child : children) {
+    waitpid(child, nullptr, 0);
+  }
+
+  std::sort(latencies_us.begin(), latencies_us.end());
+  std::cout << "samples: " << latencies_us.size() << std::endl;
+  std::cout << "p50: " << percentile(latencies_us, 0.50) << " us" << std::endl;
+  std::cout << "p99: " << percentile(latencies_us, 0.99) << " us" << std::endl;
+  std::cout << "p99.9: " << percentile(latencies_us, 0.999) << " us"
+            << std::endl;
+  std::cout << "max: " << latencies_us.back() << " us" << std::endl;
+  return 0;
+}
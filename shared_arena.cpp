@@ -0,0 +1,211 @@
+#include "shared_arena.h"
+#include "optimized_status.h"
+#include "shm_common.h"
+#include <cstring>
+
+namespace {
+
+const uint64_t BLOCK_USED = 1;
+const uint64_t BLOCK_MAGIC = 0x41524e41424c4b00ULL; // 已分配块的校验字
+const uint64_t MIN_BLOCK_SIZE = 2 * ARENA_ALIGNMENT;
+// 偏移0用作空值，第一个块从一个对齐单位之后开始
+const uint64_t FIRST_BLOCK = ARENA_ALIGNMENT;
+
+class ArenaLock {
+public:
+    explicit ArenaLock(pthread_mutex_t *mutex) : mutex_(mutex) { pthread_mutex_lock(mutex_); }
+    ~ArenaLock() { pthread_mutex_unlock(mutex_); }
+
+private:
+    pthread_mutex_t *mutex_;
+};
+
+} // namespace
+
+// 块头：size含块头且为ARENA_ALIGNMENT的倍数，最低位表示已分配；
+// 空闲块的第二个字是下一个空闲块的偏移，已分配块是校验字
+struct SharedArena::BlockHeader {
+    uint64_t size;
+    uint64_t next_or_magic;
+};
+
+static_assert(sizeof(uint64_t) * 2 == ARENA_ALIGNMENT, "block header must keep payload aligned");
+
+void SharedArena::init(SharedArenaData *data, bool priority_inherit) {
+    initSharedMutex(&data->mutex, priority_inherit);
+    memset(data->roots, 0, sizeof(data->roots));
+    data->used_bytes = 0;
+    data->free_head = FIRST_BLOCK;
+
+    BlockHeader *first = reinterpret_cast<BlockHeader *>(data->heap + FIRST_BLOCK);
+    first->size = SHARED_ARENA_SIZE - FIRST_BLOCK;
+    first->next_or_magic = 0;
+}
+
+SharedArena::BlockHeader *SharedArena::block(uint64_t offset) const {
+    return reinterpret_cast<BlockHeader *>(data_->heap + offset);
+}
+
+void *SharedArena::allocate(size_t size) {
+    if (size == 0 || size > SHARED_ARENA_SIZE) {
+        return nullptr;
+    }
+    uint64_t needed = (size + sizeof(BlockHeader) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+
+    ArenaLock lock(&data_->mutex);
+    // 首次适配
+    uint64_t prev = 0;
+    uint64_t current = data_->free_head;
+    while (current != 0 && block(current)->size < needed) {
+        prev = current;
+        current = block(current)->next_or_magic;
+    }
+    if (current == 0) {
+        return nullptr;
+    }
+
+    BlockHeader *found = block(current);
+    uint64_t next = found->next_or_magic;
+    if (found->size - needed >= MIN_BLOCK_SIZE) {
+        // 拆分，剩余部分留在链表原位置
+        BlockHeader *rest = block(current + needed);
+        rest->size = found->size - needed;
+        rest->next_or_magic = next;
+        next = current + needed;
+        found->size = needed;
+    }
+    if (prev == 0) {
+        data_->free_head = next;
+    } else {
+        block(prev)->next_or_magic = next;
+    }
+
+    data_->used_bytes += found->size;
+    found->size |= BLOCK_USED;
+    found->next_or_magic = BLOCK_MAGIC;
+    return found + 1;
+}
+
+void SharedArena::deallocate(void *ptr) {
+    if (ptr == nullptr || !contains(ptr)) {
+        return;
+    }
+    uint64_t offset = static_cast<uint64_t>(static_cast<char *>(ptr) - data_->heap) - sizeof(BlockHeader);
+
+    ArenaLock lock(&data_->mutex);
+    BlockHeader *freed = block(offset);
+    if (!(freed->size & BLOCK_USED) || freed->next_or_magic != BLOCK_MAGIC) {
+        return;  // 重复释放或不是分配结果
+    }
+    freed->size &= ~BLOCK_USED;
+    data_->used_bytes -= freed->size;
+
+    // 按地址插入空闲链表，并与相邻的空闲块合并
+    uint64_t prev = 0;
+    uint64_t current = data_->free_head;
+    while (current != 0 && current < offset) {
+        prev = current;
+        current = block(current)->next_or_magic;
+    }
+    freed->next_or_magic = current;
+    if (current != 0 && offset + freed->size == current) {
+        freed->size += block(current)->size;
+        freed->next_or_magic = block(current)->next_or_magic;
+    }
+    if (prev == 0) {
+        data_->free_head = offset;
+    } else if (prev + block(prev)->size == offset) {
+        block(prev)->size += freed->size;
+        block(prev)->next_or_magic = freed->next_or_magic;
+    } else {
+        block(prev)->next_or_magic = offset;
+    }
+}
+
+ArenaRoot *SharedArena::findRoot(const std::string &name) {
+    for (int i = 0; i < ARENA_ROOT_COUNT; ++i) {
+        ArenaRoot &root = data_->roots[i];
+        if (root.offset != 0 && name == root.name) {
+            return &root;
+        }
+    }
+    return nullptr;
+}
+
+void *SharedArena::allocateNamed(const std::string &name, size_t size) {
+    if (name.empty() || name.length() >= ARENA_ROOT_NAME_LEN) {
+        return nullptr;
+    }
+
+    ArenaLock lock(&data_->mutex);
+    ArenaRoot *root = findRoot(name);
+    if (root != nullptr) {
+        return root->size >= size ? data_->heap + root->offset : nullptr;
+    }
+
+    ArenaRoot *slot = nullptr;
+    for (int i = 0; i < ARENA_ROOT_COUNT && slot == nullptr; ++i) {
+        if (data_->roots[i].offset == 0) {
+            slot = &data_->roots[i];
+        }
+    }
+    if (slot == nullptr) {
+        return nullptr;
+    }
+    // 互斥锁可重入，allocate在同一次持锁内完成
+    void *ptr = allocate(size);
+    if (ptr == nullptr) {
+        return nullptr;
+    }
+    memset(ptr, 0, size);
+    strncpy(slot->name, name.c_str(), ARENA_ROOT_NAME_LEN - 1);
+    slot->name[ARENA_ROOT_NAME_LEN - 1] = '\0';
+    slot->size = size;
+    slot->offset = static_cast<uint64_t>(static_cast<char *>(ptr) - data_->heap);
+    return ptr;
+}
+
+void *SharedArena::findNamed(const std::string &name, size_t *size) {
+    ArenaLock lock(&data_->mutex);
+    ArenaRoot *root = findRoot(name);
+    if (root == nullptr) {
+        return nullptr;
+    }
+    if (size != nullptr) {
+        *size = root->size;
+    }
+    return data_->heap + root->offset;
+}
+
+int SharedArena::freeNamed(const std::string &name) {
+    ArenaLock lock(&data_->mutex);
+    ArenaRoot *root = findRoot(name);
+    if (root == nullptr) {
+        return NOT_FOUND;
+    }
+    void *ptr = data_->heap + root->offset;
+    memset(root, 0, sizeof(*root));
+    deallocate(ptr);
+    return OK;
+}
+
+int SharedArena::listNamed(std::vector<std::string> &names) {
+    names.clear();
+    ArenaLock lock(&data_->mutex);
+    for (int i = 0; i < ARENA_ROOT_COUNT; ++i) {
+        if (data_->roots[i].offset != 0) {
+            names.push_back(data_->roots[i].name);
+        }
+    }
+    return static_cast<int>(names.size());
+}
+
+size_t SharedArena::usedBytes() const {
+    ArenaLock lock(&data_->mutex);
+    return data_->used_bytes;
+}
+
+bool SharedArena::contains(const void *ptr) const {
+    const char *p = static_cast<const char *>(ptr);
+    return p >= data_->heap + FIRST_BLOCK + sizeof(BlockHeader) && p < data_->heap + SHARED_ARENA_SIZE;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+// 段内通用内存区：与键值表位于同一个映射中，供进程间共享其他数据结构
+// （查找数组、小型图等），避免为它们另建共享内存段
+const size_t SHARED_ARENA_SIZE = 4 << 20; // 堆大小，4MiB
+const size_t ARENA_ALIGNMENT = 16;        // 分配结果的对齐
+const int ARENA_ROOT_COUNT = 64;
+const int ARENA_ROOT_NAME_LEN = 32;
+
+// 自相对指针：保存目标与自身地址之差，放在段内时在任何映射地址下都有效。
+// 复制时按新位置重新计算差值；差值0表示空指针，清零的内存即为一组空指针，
+// 因此指针不能指向自身
+template <class T> class OffsetPtr {
+public:
+  OffsetPtr() : offset_(NULL_OFFSET) {}
+  OffsetPtr(T *ptr) { set(ptr); }
+  OffsetPtr(const OffsetPtr &other) { set(other.get()); }
+  OffsetPtr &operator=(const OffsetPtr &other) {
+    set(other.get());
+    return *this;
+  }
+  OffsetPtr &operator=(T *ptr) {
+    set(ptr);
+    return *this;
+  }
+
+  T *get() const {
+    if (offset_ == NULL_OFFSET) {
+      return nullptr;
+    }
+    return reinterpret_cast<T *>(reinterpret_cast<intptr_t>(this) + offset_);
+  }
+  T *operator->() const { return get(); }
+  T &operator*() const { return *get(); }
+  T &operator[](size_t i) const { return get()[i]; }
+  explicit operator bool() const { return offset_ != NULL_OFFSET; }
+
+private:
+  static const intptr_t NULL_OFFSET = 0;
+
+  void set(T *ptr) {
+    offset_ = ptr == nullptr ? NULL_OFFSET
+                             : reinterpret_cast<intptr_t>(ptr) -
+                                   reinterpret_cast<intptr_t>(this);
+  }
+
+  intptr_t offset_;
+};
+
+// 具名根：名称到堆内偏移的目录，各进程据此找到共享对象
+struct ArenaRoot {
+  char name[ARENA_ROOT_NAME_LEN];
+  uint64_t offset; // 0表示未使用
+  uint64_t size;
+};
+
+// 共享内存中的堆；除mutex外的布局不随段版本改变，迁移时按原样复制，
+// 堆内的偏移与OffsetPtr因此保持有效
+struct SharedArenaData {
+  pthread_mutex_t mutex;
+  uint64_t free_head;  // 按地址排序的空闲块链表，0表示空
+  uint64_t used_bytes; // 已分配块（含块头）的总大小
+  ArenaRoot roots[ARENA_ROOT_COUNT];
+  alignas(64) char heap[SHARED_ARENA_SIZE];
+};
+
+// SharedArenaData的无状态访问器，所有操作在arena自身的互斥锁下进行
+class SharedArena {
+public:
+  explicit SharedArena(SharedArenaData *data) : data_(data) {}
+
+  static void init(SharedArenaData *data, bool priority_inherit);
+
+  // 失败返回nullptr；结果按ARENA_ALIGNMENT对齐，内容未初始化
+  void *allocate(size_t size);
+  void deallocate(void *ptr);
+
+  // 具名对象：不存在时分配size字节（清零）并登记，已存在时返回现有对象，
+  // 现有对象小于size时返回nullptr。多个进程并发调用只会创建一次
+  void *allocateNamed(const std::string &name, size_t size);
+  void *findNamed(const std::string &name, size_t *size = nullptr);
+  // 注销并释放，不存在返回NOT_FOUND
+  int freeNamed(const std::string &name);
+  int listNamed(std::vector<std::string> &names);
+
+  size_t capacity() const { return SHARED_ARENA_SIZE; }
+  size_t usedBytes() const;
+  bool contains(const void *ptr) const;
+
+private:
+  struct BlockHeader;
+
+  BlockHeader *block(uint64_t offset) const;
+  ArenaRoot *findRoot(const std::string &name);
+
+private:
+  SharedArenaData *data_;
+};
@@ -1,4 +1,6 @@
 #include "shared_memory_export.h"
+#include "metrics_exporter.h"
+#include "shm_queue.h"
 #include <iostream>
 
 extern "C" {
@@ -13,6 +15,18 @@ ISharedMemoryManager *getSharedMemoryManager() {
   }
 }
 
+ISharedMemoryManager *getKeyspaceManager(const char *name) {
+  if (name == nullptr) {
+    return nullptr;
+  }
+  try {
+    return OptimizedStatusRscManager::getKeyspace(name);
+  } catch (const std::exception &e) {
+    std::cerr << "Error getting keyspace manager: " << e.what() << std::endl;
+    return nullptr;
+  }
+}
+
 int cleanupSharedMemory() {
   try {
     return OptimizedStatusRscManager::cleanup();
@@ -22,4 +36,268 @@ int cleanupSharedMemory() {
   }
 }
 
+int migrateSharedMemory() {
+  try {
+    return OptimizedStatusRscManager::migrate();
+  } catch (const std::exception &e) {
+    std::cerr << "Error migrating shared memory: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+ISharedMemoryManager *getCuckooSharedMemoryManager() {
+  try {
+    return &CuckooStatusRscManager::getInstance();
+  } catch (const std::exception &e) {
+    std::cerr << "Error getting cuckoo shared memory manager: " << e.what()
+              << std::endl;
+    return nullptr;
+  }
+}
+
+int cleanupCuckooSharedMemory() {
+  try {
+    return CuckooStatusRscManager::cleanup();
+  } catch (const std::exception &e) {
+    std::cerr << "Error cleaning up cuckoo shared memory: " << e.what()
+              << std::endl;
+    return -1;
+  }
+}
+
+ISharedMemoryManager *getNamedCuckooSharedMemoryManager(const char *name) {
+  if (name == nullptr) {
+    return nullptr;
+  }
+  try {
+    return &CuckooStatusRscManager::getInstance(name);
+  } catch (const std::exception &e) {
+    std::cerr << "Error getting cuckoo shared memory manager: " << e.what()
+              << std::endl;
+    return nullptr;
+  }
+}
+
+int cleanupNamedCuckooSharedMemory(const char *name) {
+  if (name == nullptr) {
+    return -1;
+  }
+  try {
+    return CuckooStatusRscManager::cleanup(name);
+  } catch (const std::exception &e) {
+    std::cerr << "Error cleaning up cuckoo shared memory: " << e.what()
+              << std::endl;
+    return -1;
+  }
+}
+
+ISharedMemoryManager *getSpecializedSharedMemoryManager(const char *name,
+                                                        int capacity,
+                                                        int value_len,
+                                                        int key_size) {
+  if (name == nullptr) {
+    return nullptr;
+  }
+  try {
+    if (capacity <= 0) {
+      return &SpecializedStatusRscManager::getInstance(name);
+    }
+    EngineConfig config = {capacity, value_len, key_size};
+    return &SpecializedStatusRscManager::getInstance(name, &config);
+  } catch (const std::exception &e) {
+    std::cerr << "Error getting specialized shared memory manager: "
+              << e.what() << std::endl;
+    return nullptr;
+  }
+}
+
+int cleanupSpecializedSharedMemory(const char *name) {
+  if (name == nullptr) {
+    return -1;
+  }
+  try {
+    return SpecializedStatusRscManager::cleanup(name);
+  } catch (const std::exception &e) {
+    std::cerr << "Error cleaning up specialized shared memory: " << e.what()
+              << std::endl;
+    return -1;
+  }
+}
+
+void *sharedArenaAllocate(size_t size) {
+  try {
+    return OptimizedStatusRscManager::sharedArena().allocate(size);
+  } catch (const std::exception &e) {
+    std::cerr << "Error allocating from shared arena: " << e.what()
+              << std::endl;
+    return nullptr;
+  }
+}
+
+void sharedArenaFree(void *ptr) {
+  try {
+    OptimizedStatusRscManager::sharedArena().deallocate(ptr);
+  } catch (const std::exception &e) {
+    std::cerr << "Error freeing to shared arena: " << e.what() << std::endl;
+  }
+}
+
+void *sharedArenaAllocateNamed(const char *name, size_t size) {
+  if (name == nullptr) {
+    return nullptr;
+  }
+  try {
+    return OptimizedStatusRscManager::sharedArena().allocateNamed(name, size);
+  } catch (const std::exception &e) {
+    std::cerr << "Error allocating from shared arena: " << e.what()
+              << std::endl;
+    return nullptr;
+  }
+}
+
+void *sharedArenaFindNamed(const char *name) {
+  if (name == nullptr) {
+    return nullptr;
+  }
+  try {
+    return OptimizedStatusRscManager::sharedArena().findNamed(name);
+  } catch (const std::exception &e) {
+    std::cerr << "Error looking up shared arena: " << e.what() << std::endl;
+    return nullptr;
+  }
+}
+
+int sharedArenaFreeNamed(const char *name) {
+  if (name == nullptr) {
+    return -1;
+  }
+  try {
+    return OptimizedStatusRscManager::sharedArena().freeNamed(name);
+  } catch (const std::exception &e) {
+    std::cerr << "Error freeing to shared arena: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+void *shmQueueCreate(const char *name, int kind, int capacity,
+                     int message_size) {
+  if (name == nullptr) {
+    return nullptr;
+  }
+  try {
+    return ShmQueue::create(OptimizedStatusRscManager::sharedArena(), name,
+                            static_cast<ShmQueueKind>(kind), capacity,
+                            message_size);
+  } catch (const std::exception &e) {
+    std::cerr << "Error creating shared memory queue: " << e.what()
+              << std::endl;
+    return nullptr;
+  }
+}
+
+void *shmQueueOpen(const char *name) {
+  if (name == nullptr) {
+    return nullptr;
+  }
+  try {
+    return ShmQueue::open(OptimizedStatusRscManager::sharedArena(), name);
+  } catch (const std::exception &e) {
+    std::cerr << "Error opening shared memory queue: " << e.what()
+              << std::endl;
+    return nullptr;
+  }
+}
+
+int shmQueueDestroy(const char *name) {
+  if (name == nullptr) {
+    return -1;
+  }
+  try {
+    return ShmQueue::destroy(OptimizedStatusRscManager::sharedArena(), name);
+  } catch (const std::exception &e) {
+    std::cerr << "Error destroying shared memory queue: " << e.what()
+              << std::endl;
+    return -1;
+  }
+}
+
+// 句柄直接指向段内的队列头，入队出队不会抛出异常
+int shmQueueEnqueue(void *queue, const void *data, size_t length,
+                    int timeout_ms) {
+  if (queue == nullptr || (data == nullptr && length > 0)) {
+    return -1;
+  }
+  return ShmQueue(static_cast<ShmQueueHeader *>(queue))
+      .enqueue(data, length, timeout_ms);
+}
+
+int shmQueueDequeue(void *queue, void *buffer, size_t buffer_size,
+                    size_t *length, int timeout_ms) {
+  if (queue == nullptr || (buffer == nullptr && buffer_size > 0)) {
+    return -1;
+  }
+  return ShmQueue(static_cast<ShmQueueHeader *>(queue))
+      .dequeue(buffer, buffer_size, length, timeout_ms);
+}
+
+int shmQueueEnqueueBatch(void *queue, const void *const *data,
+                         const size_t *lengths, int count, int timeout_ms) {
+  if (queue == nullptr || count < 0 ||
+      (count > 0 && (data == nullptr || lengths == nullptr))) {
+    return -1;
+  }
+  return ShmQueue(static_cast<ShmQueueHeader *>(queue))
+      .enqueueBatch(data, lengths, count, timeout_ms);
+}
+
+int shmQueueDequeueBatch(void *queue, void *buffer, size_t stride,
+                         size_t *lengths, int max_count, int timeout_ms) {
+  if (queue == nullptr || (buffer == nullptr && stride > 0)) {
+    return -1;
+  }
+  return ShmQueue(static_cast<ShmQueueHeader *>(queue))
+      .dequeueBatch(buffer, stride, lengths, max_count, timeout_ms);
+}
+
+int shmQueueSize(void *queue) {
+  if (queue == nullptr) {
+    return -1;
+  }
+  return ShmQueue(static_cast<ShmQueueHeader *>(queue)).size();
+}
+
+int writeSharedMemoryMetrics(const char *path) {
+  if (path == nullptr) {
+    return -1;
+  }
+  try {
+    return writeOpenMetricsFile(path);
+  } catch (const std::exception &e) {
+    std::cerr << "Error writing shared memory metrics: " << e.what()
+              << std::endl;
+    return -1;
+  }
+}
+
+int setSharedMemoryMetricsEnabled(int enabled) {
+  try {
+    std::vector<std::string> names;
+    OptimizedStatusRscManager::listKeyspaces(names);
+    int count = 0;
+    for (const std::string &name : names) {
+      OptimizedStatusRscManager *manager =
+          OptimizedStatusRscManager::getKeyspace(name);
+      if (manager != nullptr) {
+        manager->setMetricsEnabled(enabled != 0);
+        count++;
+      }
+    }
+    return count;
+  } catch (const std::exception &e) {
+    std::cerr << "Error setting shared memory metrics: " << e.what()
+              << std::endl;
+    return -1;
+  }
+}
+
 } // extern "C"
@@ -1,9 +1,58 @@
 #pragma once
 
+#include "cuckoo_status.h"
 #include "optimized_status.h"
+#include "specialized_status.h"
 
 extern "C" {
-// 只导出这两个函数
 ISharedMemoryManager *getSharedMemoryManager();
+// 按名称获取键空间，不存在则创建；与默认管理器共享同一个映射
+ISharedMemoryManager *getKeyspaceManager(const char *name);
 int cleanupSharedMemory();
+// 把旧布局版本的段迁移为当前布局，返回迁移的条目数，失败返回负值
+int migrateSharedMemory();
+
+// 布谷鸟哈希引擎，使用独立的共享内存段，便于与默认引擎对比
+ISharedMemoryManager *getCuckooSharedMemoryManager();
+int cleanupCuckooSharedMemory();
+// 名为name的独立布谷鸟段，与上面的默认段互不影响
+ISharedMemoryManager *getNamedCuckooSharedMemoryManager(const char *name);
+int cleanupNamedCuckooSharedMemory(const char *name);
+
+// 编译期特化引擎：按名称打开独立的共享内存段，不存在时按给定配置创建；
+// capacity为0时只附加已有段，按段头选择对应的特化版本
+ISharedMemoryManager *getSpecializedSharedMemoryManager(const char *name,
+                                                        int capacity,
+                                                        int value_len,
+                                                        int key_size);
+int cleanupSpecializedSharedMemory(const char *name);
+
+// 段内通用内存区：返回本进程中的地址，失败返回nullptr
+void *sharedArenaAllocate(size_t size);
+void sharedArenaFree(void *ptr);
+// 具名对象不存在时分配并清零，已存在时返回现有对象
+void *sharedArenaAllocateNamed(const char *name, size_t size);
+void *sharedArenaFindNamed(const char *name);
+int sharedArenaFreeNamed(const char *name);
+
+// 段内消息队列：kind为QUEUE_SPSC或QUEUE_MPMC，返回的句柄只在本进程内有效。
+// timeout_ms为0时不阻塞，小于0时一直等待；返回值同ShmQueue的对应方法
+void *shmQueueCreate(const char *name, int kind, int capacity,
+                     int message_size);
+void *shmQueueOpen(const char *name);
+int shmQueueDestroy(const char *name);
+int shmQueueEnqueue(void *queue, const void *data, size_t length,
+                    int timeout_ms);
+int shmQueueDequeue(void *queue, void *buffer, size_t buffer_size,
+                    size_t *length, int timeout_ms);
+int shmQueueEnqueueBatch(void *queue, const void *const *data,
+                         const size_t *lengths, int count, int timeout_ms);
+int shmQueueDequeueBatch(void *queue, void *buffer, size_t stride,
+                         size_t *lengths, int max_count, int timeout_ms);
+int shmQueueSize(void *queue);
+
+// 以OpenMetrics文本格式把所有键空间的统计写入文件，返回OK或IO_ERR
+int writeSharedMemoryMetrics(const char *path);
+// 为所有已有键空间开启或关闭操作与锁统计（默认关闭），返回涉及的键空间数
+int setSharedMemoryMetricsEnabled(int enabled);
 }
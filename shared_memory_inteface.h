@@ -23,4 +23,15 @@ public:
 
   virtual int batchUpdateRsc(const std::map<int, std::string> &updated_map) = 0;
   virtual int batchGetRsc(std::map<int, std::string> &fetched_map) = 0;
+  // 一次加锁完成多条插入或更新，返回成功条数。
+  // 追加在末尾且带默认实现（逐条upsertRsc），已有的实现无需修改
+  virtual int batchUpsertRsc(const std::map<int, std::string> &upserted_map) {
+    int success_count = 0;
+    for (const auto &pair : upserted_map) {
+      if (upsertRsc(pair.first, pair.second) == 0) { // OK
+        success_count++;
+      }
+    }
+    return success_count;
+  }
 };
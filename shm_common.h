@@ -0,0 +1,33 @@
+#pragma once
+
+#include <pthread.h>
+
+// 初始化放在共享内存中的进程间递归互斥锁
+// priority_inherit为true时使用优先级继承协议，持锁的低优先级进程临时继承
+// 等待者的优先级；平台不支持时退化为普通锁，返回实际是否启用
+// robust为true时持锁进程退出后下一个加锁者得到EOWNERDEAD，须修复数据后调用
+// pthread_mutex_consistent
+inline bool initSharedMutex(pthread_mutex_t *mutex,
+                            bool priority_inherit = false,
+                            bool robust = false) {
+  pthread_mutexattr_t mutex_attr;
+  pthread_mutexattr_init(&mutex_attr);
+  pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
+  pthread_mutexattr_settype(&mutex_attr, PTHREAD_MUTEX_RECURSIVE);
+  if (robust) {
+    pthread_mutexattr_setrobust(&mutex_attr, PTHREAD_MUTEX_ROBUST);
+  }
+  if (priority_inherit &&
+      pthread_mutexattr_setprotocol(&mutex_attr, PTHREAD_PRIO_INHERIT) != 0) {
+    priority_inherit = false;
+  }
+
+  if (pthread_mutex_init(mutex, &mutex_attr) != 0 && priority_inherit) {
+    pthread_mutexattr_setprotocol(&mutex_attr, PTHREAD_PRIO_NONE);
+    pthread_mutex_init(mutex, &mutex_attr);
+    priority_inherit = false;
+  }
+
+  pthread_mutexattr_destroy(&mutex_attr);
+  return priority_inherit;
+}
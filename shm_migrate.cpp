@@ -0,0 +1,20 @@
+/*
+ * 共享内存段布局迁移工具
+ * 升级后运行一次：若现有段由旧布局版本创建，则按当前布局重建并搬迁全部条目，
+ * 避免清空共享内存后重新灌数据。迁移期间旧段的写操作被阻塞，旧版本进程需要重启。
+ * 运行: ./shm_migrate
+ */
+
+#include "shared_memory_export.h"
+#include <iostream>
+
+int main() {
+  int result = migrateSharedMemory();
+  if (result < 0) {
+    std::cerr << "✗ Migration failed (" << result << ")" << std::endl;
+    return 1;
+  }
+  std::cout << "✓ Migrated " << result << " entries, segment uses layout version "
+            << SEGMENT_LAYOUT_VERSION << std::endl;
+  return 0;
+}
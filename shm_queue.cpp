@@ -0,0 +1,409 @@
+#include "shm_queue.h"
+#include "optimized_status.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <sched.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+namespace {
+
+enum QueueState { QUEUE_UNINITIALIZED = 0, QUEUE_INITIALIZING = 1, QUEUE_READY = 2 };
+
+// 创建者在初始化途中退出时，等待方最多让出这么多次后放弃
+const int MAX_READY_SPINS = 100000;
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32 bits");
+
+typedef std::chrono::steady_clock Clock;
+
+// 等待*word不再等于expected，timeout_ms小于0时不限时；可能提前返回
+void futexWait(std::atomic<uint32_t> *word, uint32_t expected, int timeout_ms) {
+#ifdef __linux__
+    struct timespec ts;
+    struct timespec *timeout = nullptr;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+        timeout = &ts;
+    }
+    // 队列跨进程共享，不能使用FUTEX_PRIVATE_FLAG
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+#else
+    // 没有futex的平台退化为短暂休眠后重新检查
+    if (word->load(std::memory_order_acquire) == expected) {
+        usleep(timeout_ms >= 0 && timeout_ms < 1 ? 0 : 1000);
+    }
+#endif
+}
+
+void futexWakeAll(std::atomic<uint32_t> *word) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+// 对端可能在等待时递增序号并唤醒；没有等待者时不进入内核
+void notify(std::atomic<uint32_t> &seq, std::atomic<uint32_t> &waiters) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) > 0) {
+        seq.fetch_add(1, std::memory_order_release);
+        futexWakeAll(&seq);
+    }
+}
+
+// 登记为等待者后再检查ready，仍未就绪时在seq上睡眠。已超时返回false
+template <class Ready>
+bool waitUntil(std::atomic<uint32_t> &seq, std::atomic<uint32_t> &waiters, Ready ready,
+               int timeout_ms, const Clock::time_point &deadline) {
+    int remaining_ms = -1;
+    if (timeout_ms > 0) {
+        Clock::time_point now = Clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        remaining_ms = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count());
+        if (remaining_ms == 0) {
+            remaining_ms = 1;
+        }
+    }
+
+    waiters.fetch_add(1, std::memory_order_seq_cst);
+    uint32_t observed = seq.load(std::memory_order_seq_cst);
+    if (!ready()) {
+        futexWait(&seq, observed, remaining_ms);
+    }
+    waiters.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+// 等待另一个生产者或消费者完成对同一槽位的复制，窗口只有一次memcpy
+void waitSequence(const ShmQueueSlot *slot, uint64_t expected) {
+    for (int spins = 0; slot->sequence.load(std::memory_order_acquire) != expected; ++spins) {
+        if (spins > 64) {
+            sched_yield();
+        }
+    }
+}
+
+bool waitReady(ShmQueueHeader *header) {
+    for (int spins = 0; header->state.load(std::memory_order_acquire) != QUEUE_READY; ++spins) {
+        if (spins >= MAX_READY_SPINS) {
+            return false;
+        }
+        sched_yield();
+    }
+    return header->magic == SHM_QUEUE_MAGIC;
+}
+
+size_t slotSize(int message_size) {
+    return (offsetof(ShmQueueSlot, data) + message_size + 7) & ~static_cast<size_t>(7);
+}
+
+} // namespace
+
+size_t ShmQueue::requiredSize(int capacity, int message_size) {
+    return offsetof(ShmQueueHeader, slots) + static_cast<size_t>(capacity) * slotSize(message_size);
+}
+
+ShmQueueHeader *ShmQueue::create(SharedArena arena, const std::string &name, ShmQueueKind kind,
+                                 int capacity, int message_size) {
+    if ((kind != QUEUE_SPSC && kind != QUEUE_MPMC) || capacity <= 0 ||
+        (capacity & (capacity - 1)) != 0 || capacity > static_cast<int>(SHARED_ARENA_SIZE) ||
+        message_size <= 0 || message_size > MAX_QUEUE_MESSAGE) {
+        return nullptr;
+    }
+
+    // allocateNamed保证并发创建只分配一次，初始化由抢到state的进程完成
+    ShmQueueHeader *header = static_cast<ShmQueueHeader *>(
+        arena.allocateNamed(name, requiredSize(capacity, message_size)));
+    if (header == nullptr) {
+        return nullptr;
+    }
+
+    uint32_t expected = QUEUE_UNINITIALIZED;
+    if (header->state.compare_exchange_strong(expected, QUEUE_INITIALIZING,
+                                              std::memory_order_acq_rel)) {
+        header->magic = SHM_QUEUE_MAGIC;
+        header->kind = kind;
+        header->capacity = static_cast<uint32_t>(capacity);
+        header->message_size = static_cast<uint32_t>(message_size);
+        header->slot_size = static_cast<uint32_t>(slotSize(message_size));
+        header->tail.store(0, std::memory_order_relaxed);
+        header->head.store(0, std::memory_order_relaxed);
+        header->cached_head = 0;
+        header->cached_tail = 0;
+        ShmQueue queue(header);
+        for (int i = 0; i < capacity; ++i) {
+            queue.slot(i)->sequence.store(i, std::memory_order_relaxed);
+        }
+        header->state.store(QUEUE_READY, std::memory_order_release);
+        return header;
+    }
+
+    if (!waitReady(header) || header->kind != static_cast<uint32_t>(kind) ||
+        header->capacity != static_cast<uint32_t>(capacity) ||
+        header->message_size != static_cast<uint32_t>(message_size)) {
+        return nullptr;
+    }
+    return header;
+}
+
+ShmQueueHeader *ShmQueue::open(SharedArena arena, const std::string &name) {
+    size_t size = 0;
+    ShmQueueHeader *header = static_cast<ShmQueueHeader *>(arena.findNamed(name, &size));
+    if (header == nullptr || size < offsetof(ShmQueueHeader, slots) || !waitReady(header) ||
+        size < requiredSize(header->capacity, header->message_size)) {
+        return nullptr;
+    }
+    return header;
+}
+
+int ShmQueue::destroy(SharedArena arena, const std::string &name) {
+    if (open(arena, name) == nullptr) {
+        return NOT_FOUND;
+    }
+    return arena.freeNamed(name);
+}
+
+ShmQueueSlot *ShmQueue::slot(uint64_t position) const {
+    uint64_t index = position & (header_->capacity - 1);
+    return reinterpret_cast<ShmQueueSlot *>(header_->slots + index * header_->slot_size);
+}
+
+int ShmQueue::claimWrite(int count, uint64_t *first) {
+    uint64_t capacity = header_->capacity;
+    uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+
+    if (header_->kind == QUEUE_SPSC) {
+        // 只有生产者写tail与cached_head，空间不够时才去读消费者的缓存行
+        uint64_t free_slots = capacity - (tail - header_->cached_head);
+        if (free_slots < static_cast<uint64_t>(count)) {
+            header_->cached_head = header_->head.load(std::memory_order_acquire);
+            free_slots = capacity - (tail - header_->cached_head);
+        }
+        *first = tail;
+        return static_cast<int>(std::min<uint64_t>(free_slots, count));
+    }
+
+    // MPMC：按已被消费者预留的位置估算空位，一次CAS预留一段连续位置
+    while (true) {
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        uint64_t used = tail > head ? tail - head : 0;
+        uint64_t free_slots = used < capacity ? capacity - used : 0;
+        uint64_t n = std::min<uint64_t>(free_slots, count);
+        if (n == 0) {
+            return 0;
+        }
+        if (header_->tail.compare_exchange_weak(tail, tail + n, std::memory_order_acq_rel,
+                                                std::memory_order_relaxed)) {
+            *first = tail;
+            return static_cast<int>(n);
+        }
+    }
+}
+
+int ShmQueue::claimRead(int count, uint64_t *first) {
+    uint64_t head = header_->head.load(std::memory_order_relaxed);
+
+    if (header_->kind == QUEUE_SPSC) {
+        uint64_t available = header_->cached_tail - head;
+        if (available < static_cast<uint64_t>(count)) {
+            header_->cached_tail = header_->tail.load(std::memory_order_acquire);
+            available = header_->cached_tail - head;
+        }
+        *first = head;
+        return static_cast<int>(std::min<uint64_t>(available, count));
+    }
+
+    while (true) {
+        uint64_t tail = header_->tail.load(std::memory_order_acquire);
+        uint64_t n = std::min<uint64_t>(tail > head ? tail - head : 0, count);
+        if (n == 0) {
+            return 0;
+        }
+        if (header_->head.compare_exchange_weak(head, head + n, std::memory_order_acq_rel,
+                                                std::memory_order_relaxed)) {
+            *first = head;
+            return static_cast<int>(n);
+        }
+    }
+}
+
+void ShmQueue::writeSlot(uint64_t position, const void *data, size_t length) {
+    ShmQueueSlot *s = slot(position);
+    bool mpmc = header_->kind == QUEUE_MPMC;
+    if (mpmc) {
+        waitSequence(s, position);
+    }
+    s->length = static_cast<uint32_t>(length);
+    memcpy(s->data, data, length);
+    if (mpmc) {
+        s->sequence.store(position + 1, std::memory_order_release);
+    }
+}
+
+void ShmQueue::publishWrite(uint64_t first, int count) {
+    if (header_->kind == QUEUE_SPSC) {
+        header_->tail.store(first + count, std::memory_order_release);
+    }
+    notify(header_->not_empty_seq, header_->not_empty_waiters);
+}
+
+void ShmQueue::publishRead(uint64_t first, int count) {
+    if (header_->kind == QUEUE_SPSC) {
+        header_->head.store(first + count, std::memory_order_release);
+    }
+    notify(header_->not_full_seq, header_->not_full_waiters);
+}
+
+int ShmQueue::enqueue(const void *data, size_t length, int timeout_ms) {
+    int ret = enqueueBatch(&data, &length, 1, timeout_ms);
+    if (ret < 0) {
+        return ret;
+    }
+    return ret == 1 ? OK : NO_SPACE_ERR;
+}
+
+int ShmQueue::enqueueBatch(const std::vector<std::string> &messages, int timeout_ms) {
+    std::vector<const void *> data(messages.size());
+    std::vector<size_t> lengths(messages.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+        data[i] = messages[i].data();
+        lengths[i] = messages[i].length();
+    }
+    return enqueueBatch(data.data(), lengths.data(), static_cast<int>(messages.size()),
+                        timeout_ms);
+}
+
+int ShmQueue::enqueueBatch(const void *const *data, const size_t *lengths, int count,
+                           int timeout_ms) {
+    for (int i = 0; i < count; ++i) {
+        if (lengths[i] > header_->message_size) {
+            return -1;
+        }
+    }
+
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    uint64_t capacity = header_->capacity;
+    ShmQueueHeader *header = header_;
+    int done = 0;
+    while (done < count) {
+        uint64_t first;
+        int n = claimWrite(count - done, &first);
+        if (n > 0) {
+            for (int i = 0; i < n; ++i) {
+                writeSlot(first + i, data[done + i], lengths[done + i]);
+            }
+            publishWrite(first, n);
+            done += n;
+            continue;
+        }
+
+        if (timeout_ms == 0 ||
+            !waitUntil(header_->not_full_seq, header_->not_full_waiters,
+                       [header, capacity]() {
+                           uint64_t tail = header->tail.load(std::memory_order_seq_cst);
+                           uint64_t head = header->head.load(std::memory_order_seq_cst);
+                           return tail < head || tail - head < capacity;
+                       },
+                       timeout_ms, deadline)) {
+            break;
+        }
+    }
+    return done;
+}
+
+template <class Copy> int ShmQueue::dequeueInto(int max_count, int timeout_ms, Copy copy) {
+    if (max_count <= 0) {
+        return 0;
+    }
+
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    uint64_t capacity = header_->capacity;
+    ShmQueueHeader *header = header_;
+    bool mpmc = header_->kind == QUEUE_MPMC;
+    while (true) {
+        uint64_t first;
+        int n = claimRead(max_count, &first);
+        if (n > 0) {
+            for (int i = 0; i < n; ++i) {
+                ShmQueueSlot *s = slot(first + i);
+                if (mpmc) {
+                    waitSequence(s, first + i + 1);
+                }
+                copy(i, s->data, s->length);
+                if (mpmc) {
+                    s->sequence.store(first + i + capacity, std::memory_order_release);
+                }
+            }
+            publishRead(first, n);
+            return n;
+        }
+
+        if (timeout_ms == 0 ||
+            !waitUntil(header_->not_empty_seq, header_->not_empty_waiters,
+                       [header]() {
+                           uint64_t head = header->head.load(std::memory_order_seq_cst);
+                           return header->tail.load(std::memory_order_seq_cst) > head;
+                       },
+                       timeout_ms, deadline)) {
+            return 0;
+        }
+    }
+}
+
+int ShmQueue::dequeue(void *buffer, size_t buffer_size, size_t *length, int timeout_ms) {
+    int n = dequeueInto(1, timeout_ms, [buffer, buffer_size, length](int, const char *data,
+                                                                     uint32_t size) {
+        memcpy(buffer, data, std::min<size_t>(size, buffer_size));
+        if (length != nullptr) {
+            *length = size;
+        }
+    });
+    return n == 1 ? OK : NOT_FOUND;
+}
+
+int ShmQueue::dequeue(std::string *message, int timeout_ms) {
+    int n = dequeueInto(1, timeout_ms, [message](int, const char *data, uint32_t size) {
+        message->assign(data, size);
+    });
+    return n == 1 ? OK : NOT_FOUND;
+}
+
+int ShmQueue::dequeueBatch(std::vector<std::string> &messages, int max_count, int timeout_ms) {
+    messages.clear();
+    return dequeueInto(max_count, timeout_ms, [&messages](int, const char *data, uint32_t size) {
+        messages.push_back(std::string(data, size));
+    });
+}
+
+int ShmQueue::dequeueBatch(void *buffer, size_t stride, size_t *lengths, int max_count,
+                           int timeout_ms) {
+    char *out = static_cast<char *>(buffer);
+    return dequeueInto(max_count, timeout_ms,
+                       [out, stride, lengths](int i, const char *data, uint32_t size) {
+                           memcpy(out + i * stride, data, std::min<size_t>(size, stride));
+                           if (lengths != nullptr) {
+                               lengths[i] = size;
+                           }
+                       });
+}
+
+int ShmQueue::size() const {
+    uint64_t head = header_->head.load(std::memory_order_acquire);
+    uint64_t tail = header_->tail.load(std::memory_order_acquire);
+    if (tail <= head) {
+        return 0;
+    }
+    return static_cast<int>(std::min<uint64_t>(tail - head, header_->capacity));
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "shared_arena.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 共享内存消息队列：有界环形队列，存放在段内通用内存区中，按名称创建和打开。
+// 入队出队只操作共享内存中的原子变量，只有在对端阻塞等待时才需要一次futex唤醒
+const uint32_t SHM_QUEUE_MAGIC = 0x51554555; // "QUEU"
+const int MAX_QUEUE_MESSAGE = 4096;          // 单条消息的最大长度
+
+enum ShmQueueKind {
+  QUEUE_SPSC = 0, // 单生产者单消费者
+  QUEUE_MPMC = 1, // 多生产者多消费者
+};
+
+// 槽位：sequence只在MPMC队列中使用，表示槽位可写（等于位置）或可读（等于位置+1）
+struct ShmQueueSlot {
+  std::atomic<uint64_t> sequence;
+  uint32_t length;
+  char data[4]; // 实际长度为message_size，槽位大小按8字节对齐
+};
+
+struct ShmQueueHeader {
+  std::atomic<uint32_t> state; // 0未初始化，1初始化中，2可用
+  uint32_t magic;
+  uint32_t kind;
+  uint32_t capacity; // 槽位数，2的幂次
+  uint32_t message_size;
+  uint32_t slot_size;
+
+  // 生产者与消费者的位置分别独占缓存行；SPSC队列在同一行缓存对端位置
+  alignas(64) std::atomic<uint64_t> tail;
+  uint64_t cached_head;
+  alignas(64) std::atomic<uint64_t> head;
+  uint64_t cached_tail;
+
+  // 阻塞等待：等待者先登记再检查队列，对端发现有等待者时递增序号并唤醒
+  alignas(64) std::atomic<uint32_t> not_empty_seq;
+  std::atomic<uint32_t> not_empty_waiters;
+  alignas(64) std::atomic<uint32_t> not_full_seq;
+  std::atomic<uint32_t> not_full_waiters;
+
+  alignas(64) char slots[1];
+};
+
+// ShmQueueHeader的无状态访问器。timeout_ms为0时不阻塞，小于0时一直等待
+class ShmQueue {
+public:
+  explicit ShmQueue(ShmQueueHeader *header) : header_(header) {}
+
+  // 在arena中创建队列，同名队列已存在且参数相同时直接打开；
+  // 参数不同、名称被其他对象占用或空间不足返回nullptr
+  static ShmQueueHeader *create(SharedArena arena, const std::string &name,
+                                ShmQueueKind kind, int capacity,
+                                int message_size);
+  // 打开已存在的队列，不存在返回nullptr
+  static ShmQueueHeader *open(SharedArena arena, const std::string &name);
+  // 释放队列占用的内存，调用时不能有进程仍在使用它
+  static int destroy(SharedArena arena, const std::string &name);
+  static size_t requiredSize(int capacity, int message_size);
+
+  // 成功返回OK，队列满且超时返回NO_SPACE_ERR，消息过长返回-1
+  int enqueue(const void *data, size_t length, int timeout_ms = 0);
+  // 成功返回OK，队列空且超时返回NOT_FOUND；length为消息原长，
+  // 大于buffer_size时只复制前buffer_size字节
+  int dequeue(void *buffer, size_t buffer_size, size_t *length,
+              int timeout_ms = 0);
+  int dequeue(std::string *message, int timeout_ms = 0);
+
+  // 批量入队：一次发布多条消息，阻塞时等到全部入队或超时，返回入队条数，
+  // 有消息过长返回-1且不入队任何消息
+  int enqueueBatch(const std::vector<std::string> &messages,
+                   int timeout_ms = 0);
+  int enqueueBatch(const void *const *data, const size_t *lengths, int count,
+                   int timeout_ms = 0);
+  // 批量出队：最多取出max_count条，阻塞时等到至少一条，返回出队条数
+  int dequeueBatch(std::vector<std::string> &messages, int max_count,
+                   int timeout_ms = 0);
+  // 第i条消息写入buffer + i * stride，消息长于stride时被截断
+  int dequeueBatch(void *buffer, size_t stride, size_t *lengths,
+                   int max_count, int timeout_ms = 0);
+
+  int size() const;
+  int capacity() const { return static_cast<int>(header_->capacity); }
+  int messageSize() const { return static_cast<int>(header_->message_size); }
+  ShmQueueKind kind() const { return static_cast<ShmQueueKind>(header_->kind); }
+
+private:
+  ShmQueueSlot *slot(uint64_t position) const;
+  // 预留最多count个可写/可读位置，返回实际预留数，起始位置写入first
+  int claimWrite(int count, uint64_t *first);
+  int claimRead(int count, uint64_t *first);
+  void publishWrite(uint64_t first, int count);
+  void publishRead(uint64_t first, int count);
+  void writeSlot(uint64_t position, const void *data, size_t length);
+
+  template <class Copy> int dequeueInto(int max_count, int timeout_ms, Copy copy);
+
+private:
+  ShmQueueHeader *header_;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+// USDT静态探针（provider: shared_memory）
+// 构建时找到<sys/sdt.h>则编译为一条nop指令并在.note.stapsdt中登记，
+// 未挂载时不产生任何开销；否则宏展开为空，参数不会被求值。
+//
+// 可用探针：
+//   lock_wait_start(keyspace)            开始等待table_mutex
+//   lock_wait_end(keyspace)              获得table_mutex
+//   lock_release(keyspace)               释放table_mutex
+//   probe_done(key, probes, found)       一次探测循环结束及其探测次数
+//   rehash_start(keyspace, entries)      rehash开始时的条目数（含删除标记）
+//   rehash_end(keyspace, entries)        rehash结束后的有效条目数
+//   table_full(keyspace, key)            插入因空间不足失败
+//   reseed(keyspace, generation)         探测链过长，换用新哈希种子
+//
+// 示例：统计锁等待时间分布
+//   bpftrace -e 'usdt:./libSHARED_MEM_MAP.so:shared_memory:lock_wait_start
+//                { @s[tid] = nsecs; }
+//                usdt:./libSHARED_MEM_MAP.so:shared_memory:lock_wait_end
+//                /@s[tid]/ { @wait_ns = hist(nsecs - @s[tid]); delete(@s[tid]); }'
+
+#ifdef SHM_ENABLE_USDT
+#include <sys/sdt.h>
+
+#define SHM_TRACE1(name, a) DTRACE_PROBE1(shared_memory, name, a)
+#define SHM_TRACE2(name, a, b) DTRACE_PROBE2(shared_memory, name, a, b)
+#define SHM_TRACE3(name, a, b, c) DTRACE_PROBE3(shared_memory, name, a, b, c)
+#else
+#define SHM_TRACE1(name, a) \
+  do {                      \
+  } while (0)
+#define SHM_TRACE2(name, a, b) \
+  do {                         \
+  } while (0)
+#define SHM_TRACE3(name, a, b, c) \
+  do {                            \
+  } while (0)
+#endif
@@ -0,0 +1,300 @@
+#include "snapshot.h"
+#include "batch_hash.h"
+#include "optimized_status.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char *const SNAPSHOT_ROOT_PREFIX = "snap:";
+
+// arena中的登记项：发布进程的pid与其持有的fd，0表示未发布
+struct SnapshotRecord {
+    std::atomic<uint64_t> location;
+};
+
+// 与在线表相同的双重哈希探测序列，mask为快照索引的槽位数减一
+inline uint32_t firstProbe(int key, uint32_t seed, uint32_t mask) {
+    return murmurMix1(key, seed) & mask;
+}
+
+inline uint32_t probeStep(int key, uint32_t seed, uint32_t mask) {
+    return (murmurMix2(key, seed) & mask) | 1;
+}
+
+inline uint32_t nextProbe(uint32_t pos, uint32_t step, uint32_t hash2_val, uint32_t mask) {
+    return (pos + step * hash2_val) & mask;
+}
+
+// 本进程登记的快照：名称到fd副本
+std::mutex &publishedMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::map<std::string, int> &publishedSnapshots() {
+    static std::map<std::string, int> published;
+    return published;
+}
+
+bool validName(const std::string &name) {
+    return !name.empty() && name.length() <= static_cast<size_t>(SNAPSHOT_NAME_LEN);
+}
+
+} // namespace
+
+int buildSnapshot(const std::vector<ScanArena> &parts, uint32_t hash_seed,
+                  const std::string &keyspace) {
+#ifdef __linux__
+    size_t count = 0;
+    size_t values_size = 0;
+    for (const ScanArena &part : parts) {
+        count += part.size();
+        values_size += part.values.size();
+    }
+    if (values_size > UINT32_MAX || count > static_cast<size_t>(INT_MAX / 2)) {
+        return -1;
+    }
+
+    // 装载因子不超过0.75，与在线表相同
+    uint32_t capacity = 16;
+    while (capacity / 4 * 3 < count) {
+        capacity <<= 1;
+    }
+    size_t slots_offset = (sizeof(SnapshotHeader) + CACHE_LINE_SIZE - 1) & ~static_cast<size_t>(CACHE_LINE_SIZE - 1);
+    size_t values_offset = slots_offset + capacity * sizeof(SnapshotSlot);
+    size_t total = values_offset + values_size;
+
+    int fd = memfd_create("shm_snapshot", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd == -1) {
+        return -1;
+    }
+    if (ftruncate(fd, total) == -1) {
+        close(fd);
+        return -1;
+    }
+    char *base = static_cast<char *>(mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    if (base == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    // memfd初始全为0，槽位默认即为空
+    SnapshotHeader *header = reinterpret_cast<SnapshotHeader *>(base);
+    header->magic = SNAPSHOT_MAGIC;
+    header->format_version = SNAPSHOT_FORMAT_VERSION;
+    header->capacity = capacity;
+    header->count = static_cast<uint32_t>(count);
+    header->hash_seed = hash_seed;
+    header->created_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::system_clock::now().time_since_epoch()).count();
+    header->slots_offset = slots_offset;
+    header->values_offset = values_offset;
+    header->values_size = values_size;
+    strncpy(header->keyspace, keyspace.c_str(), sizeof(header->keyspace) - 1);
+
+    // 各段的值区整体复制，索引只记录偏移
+    SnapshotSlot *slots = reinterpret_cast<SnapshotSlot *>(base + slots_offset);
+    uint32_t mask = capacity - 1;
+    uint32_t part_base = 0;
+    for (const ScanArena &part : parts) {
+        if (!part.values.empty()) {
+            memcpy(base + values_offset + part_base, part.values.data(), part.values.size());
+        }
+        for (size_t i = 0; i < part.size(); ++i) {
+            int key = part.keys[i];
+            uint32_t pos = firstProbe(key, hash_seed, mask);
+            uint32_t hash2_val = probeStep(key, hash_seed, mask);
+            for (uint32_t step = 1; slots[pos].occupied; ++step) {
+                pos = nextProbe(pos, step, hash2_val, mask);
+            }
+            slots[pos].key = key;
+            slots[pos].value_offset = part_base + part.offsets[i];
+            slots[pos].length = part.lengths[i];
+            slots[pos].occupied = 1;
+        }
+        part_base += static_cast<uint32_t>(part.values.size());
+    }
+
+    // 存在可写映射时无法加写封，先解除映射
+    munmap(base, total);
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+#else
+    (void)parts;
+    (void)hash_seed;
+    (void)keyspace;
+    return -1;
+#endif
+}
+
+int registerSnapshot(SharedArena arena, const std::string &name, int fd) {
+    if (!validName(name)) {
+        return -1;
+    }
+    int copy = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (copy == -1) {
+        return -1;
+    }
+    SnapshotRecord *record = static_cast<SnapshotRecord *>(
+        arena.allocateNamed(SNAPSHOT_ROOT_PREFIX + name, sizeof(SnapshotRecord)));
+    if (record == nullptr) {
+        close(copy);
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> guard(publishedMutex());
+    std::map<std::string, int> &published = publishedSnapshots();
+    record->location.store(static_cast<uint64_t>(getpid()) << 32 | static_cast<uint32_t>(copy),
+                           std::memory_order_release);
+    // 先发布新位置再关闭旧fd；正在按旧位置打开的读者会在校验时发现并失败
+    std::map<std::string, int>::iterator it = published.find(name);
+    if (it != published.end()) {
+        close(it->second);
+        it->second = copy;
+    } else {
+        published[name] = copy;
+    }
+    return OK;
+}
+
+int withdrawSnapshot(SharedArena arena, const std::string &name) {
+    std::lock_guard<std::mutex> guard(publishedMutex());
+    std::map<std::string, int> &published = publishedSnapshots();
+    std::map<std::string, int>::iterator it = published.find(name);
+    if (it == published.end()) {
+        return NOT_FOUND;
+    }
+
+    // 登记项已被其他进程改写时保留它
+    SnapshotRecord *record = static_cast<SnapshotRecord *>(arena.findNamed(SNAPSHOT_ROOT_PREFIX + name));
+    uint64_t ours = static_cast<uint64_t>(getpid()) << 32 | static_cast<uint32_t>(it->second);
+    if (record != nullptr && record->location.load(std::memory_order_acquire) == ours) {
+        arena.freeNamed(SNAPSHOT_ROOT_PREFIX + name);
+    }
+    close(it->second);
+    published.erase(it);
+    return OK;
+}
+
+SnapshotView::SnapshotView(int fd)
+    : base_(nullptr), size_(0), header_(nullptr), slots_(nullptr), values_(nullptr) {
+#ifdef __linux__
+    int seals = fcntl(fd, F_GET_SEALS);
+    if (seals == -1 || (seals & (F_SEAL_WRITE | F_SEAL_SHRINK)) != (F_SEAL_WRITE | F_SEAL_SHRINK)) {
+        throw std::runtime_error("snapshot fd is not sealed");
+    }
+#endif
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        throw std::runtime_error("fstat failed: " + std::string(strerror(errno)));
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ < sizeof(SnapshotHeader)) {
+        throw std::runtime_error("snapshot is truncated");
+    }
+
+    void *mapped = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("mmap failed: " + std::string(strerror(errno)));
+    }
+    base_ = static_cast<const char *>(mapped);
+    header_ = reinterpret_cast<const SnapshotHeader *>(base_);
+
+    uint32_t capacity = header_->capacity;
+    if (header_->magic != SNAPSHOT_MAGIC || header_->format_version != SNAPSHOT_FORMAT_VERSION ||
+        capacity == 0 || (capacity & (capacity - 1)) != 0 || header_->count > capacity ||
+        header_->slots_offset < sizeof(SnapshotHeader) ||
+        header_->slots_offset + capacity * sizeof(SnapshotSlot) > header_->values_offset ||
+        header_->values_offset + header_->values_size > size_) {
+        munmap(mapped, size_);
+        throw std::runtime_error("not a valid snapshot");
+    }
+    slots_ = reinterpret_cast<const SnapshotSlot *>(base_ + header_->slots_offset);
+    values_ = base_ + header_->values_offset;
+}
+
+SnapshotView::~SnapshotView() {
+    if (base_ != nullptr) {
+        munmap(const_cast<char *>(base_), size_);
+    }
+}
+
+std::unique_ptr<SnapshotView> SnapshotView::openNamed(SharedArena arena, const std::string &name) {
+    if (!validName(name)) {
+        return nullptr;
+    }
+    const SnapshotRecord *record =
+        static_cast<const SnapshotRecord *>(arena.findNamed(SNAPSHOT_ROOT_PREFIX + name));
+    uint64_t location = record != nullptr ? record->location.load(std::memory_order_acquire) : 0;
+    if (location == 0) {
+        return nullptr;
+    }
+
+    // 通过发布进程的fd重新打开同一个memfd
+    std::string path = "/proc/" + std::to_string(location >> 32) + "/fd/" +
+                       std::to_string(static_cast<uint32_t>(location));
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return nullptr;
+    }
+    std::unique_ptr<SnapshotView> view;
+    try {
+        view.reset(new SnapshotView(fd));
+    } catch (const std::runtime_error &) {
+        // fd号已被复用为其他文件
+    }
+    close(fd);
+    return view;
+}
+
+const SnapshotSlot *SnapshotView::findSlot(int key) const {
+    uint32_t mask = header_->capacity - 1;
+    uint32_t pos = firstProbe(key, header_->hash_seed, mask);
+    uint32_t hash2_val = probeStep(key, header_->hash_seed, mask);
+    for (uint32_t step = 1; step <= header_->capacity; ++step) {
+        const SnapshotSlot &slot = slots_[pos];
+        if (!slot.occupied) {
+            return nullptr;
+        }
+        if (slot.key == key) {
+            return &slot;
+        }
+        pos = nextProbe(pos, step, hash2_val, mask);
+    }
+    return nullptr;
+}
+
+bool SnapshotView::get(int key, std::string *value) const {
+    const SnapshotSlot *slot = findSlot(key);
+    if (slot == nullptr) {
+        return false;
+    }
+    if (value != nullptr) {
+        value->assign(values_ + slot->value_offset, slot->length);
+    }
+    return true;
+}
+
+void SnapshotView::forEach(
+    const std::function<void(int key, const char *value, size_t length)> &visit) const {
+    for (uint32_t i = 0; i < header_->capacity; ++i) {
+        const SnapshotSlot &slot = slots_[i];
+        if (slot.occupied) {
+            visit(slot.key, values_ + slot.value_offset, slot.length);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "shared_arena.h"
+#include "table_scan.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 只读快照：全表的紧凑副本写入memfd后加封（禁止写入、扩展和收缩），
+// 分析进程映射后不加任何锁查询。索引使用与在线表相同的哈希函数和探测序列
+const uint32_t SNAPSHOT_MAGIC = 0x534e4150; // "SNAP"
+const uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+const int SNAPSHOT_NAME_LEN = 26; // 登记名长度上限，受arena具名根的名称长度限制
+
+struct SnapshotHeader {
+  uint32_t magic;
+  uint32_t format_version;
+  uint32_t capacity; // 索引槽位数，2的幂次
+  uint32_t count;
+  uint32_t hash_seed;
+  uint32_t reserved;
+  uint64_t created_ns; // 发布时刻，system_clock
+  uint64_t slots_offset;
+  uint64_t values_offset;
+  uint64_t values_size;
+  char keyspace[32];
+};
+
+struct SnapshotSlot {
+  int key;
+  uint32_t value_offset; // 相对values区的偏移
+  uint16_t length;
+  uint8_t occupied;
+  uint8_t reserved;
+};
+
+// 把扫描结果写入新的memfd并加封，返回fd，失败返回-1。仅Linux支持
+int buildSnapshot(const std::vector<ScanArena> &parts, uint32_t hash_seed,
+                  const std::string &keyspace);
+
+// 以name登记快照，其他进程可用SnapshotView::openNamed打开。登记保存fd的副本，
+// 本进程需存活到快照被替换或撤销；同名快照被替换时旧快照的副本随之关闭
+int registerSnapshot(SharedArena arena, const std::string &name, int fd);
+int withdrawSnapshot(SharedArena arena, const std::string &name);
+
+class SnapshotView {
+public:
+  // 映射快照fd，映射后fd可以关闭；不是加封的快照时抛出std::runtime_error
+  explicit SnapshotView(int fd);
+  ~SnapshotView();
+
+  SnapshotView(const SnapshotView &) = delete;
+  SnapshotView &operator=(const SnapshotView &) = delete;
+
+  // 按登记名打开，不存在或发布进程已退出返回nullptr
+  static std::unique_ptr<SnapshotView> openNamed(SharedArena arena,
+                                                 const std::string &name);
+
+  bool get(int key, std::string *value) const;
+  bool contains(int key) const { return get(key, nullptr); }
+  // 按索引顺序遍历全部条目，值不以'\0'结尾
+  void forEach(
+      const std::function<void(int key, const char *value, size_t length)>
+          &visit) const;
+
+  int count() const { return static_cast<int>(header_->count); }
+  uint64_t createdNs() const { return header_->created_ns; }
+  std::string keyspace() const { return header_->keyspace; }
+  size_t mappedSize() const { return size_; }
+
+private:
+  const SnapshotSlot *findSlot(int key) const;
+
+private:
+  const char *base_;
+  size_t size_;
+  const SnapshotHeader *header_;
+  const SnapshotSlot *slots_;
+  const char *values_;
+};
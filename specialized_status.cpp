@@ -0,0 +1,633 @@
+#include "specialized_status.h"
+#include "shm_common.h"
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+class TableLock {
+public:
+    explicit TableLock(pthread_mutex_t *mutex) : mutex_(mutex) { pthread_mutex_lock(mutex_); }
+    ~TableLock() { pthread_mutex_unlock(mutex_); }
+
+private:
+    pthread_mutex_t *mutex_;
+};
+
+// 4字节键直接混合，8字节键先把高低32位折叠到一起
+inline int foldKey(int32_t key) { return key; }
+inline int foldKey(int64_t key) {
+    uint64_t k = static_cast<uint64_t>(key);
+    return static_cast<int>(static_cast<uint32_t>(k) ^ static_cast<uint32_t>(k >> 32));
+}
+
+template <int Capacity, int ValueLen, class Key> class SpecializedTable : public SpecializedEngine {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "capacity must be a power of two");
+    static_assert(ValueLen > 1, "value buffer must hold at least one character");
+
+    static const uint32_t MASK = Capacity - 1;
+    static const int MAX_COUNT = Capacity / 4 * 3; // 与MAX_LOAD_FACTOR相同
+
+public:
+    struct Entry {
+        Key key;
+        EntryState state;
+        char value[ValueLen];
+    };
+
+    struct Data {
+        SpecializedHeader header;
+        alignas(CACHE_LINE_SIZE) Entry entries[Capacity];
+    };
+
+    static EngineConfig config() {
+        EngineConfig result = {Capacity, ValueLen, static_cast<int>(sizeof(Key))};
+        return result;
+    }
+
+    // 创建者在发布段头之前调用
+    static void init(void *segment) {
+        Data *data = static_cast<Data *>(segment);
+        for (int i = 0; i < Capacity; ++i) {
+            data->entries[i].key = 0;
+            data->entries[i].state = EMPTY;
+            data->entries[i].value[0] = '\0';
+        }
+    }
+
+    static SpecializedEngine *attach(void *segment) {
+        return new SpecializedTable(static_cast<Data *>(segment));
+    }
+
+    explicit SpecializedTable(Data *data) : data_(data) {}
+
+    int add(int64_t key, const std::string &value) override {
+        int ret = checkWrite(key, value);
+        if (ret != OK) {
+            return ret;
+        }
+        TableLock lock(&data_->header.table_mutex);
+        int free_slot = -1;
+        if (probe(static_cast<Key>(key), &free_slot) != -1) {
+            return DUPLICATE_KEY;
+        }
+        return insertLocked(static_cast<Key>(key), value, free_slot);
+    }
+
+    int get(int64_t key, std::string *value) override {
+        if (!validKey(key)) {
+            return -1;
+        }
+        TableLock lock(&data_->header.table_mutex);
+        int pos = probe(static_cast<Key>(key), nullptr);
+        if (pos == -1) {
+            return NOT_FOUND;
+        }
+        if (value != nullptr) {
+            value->assign(data_->entries[pos].value);
+        }
+        return OK;
+    }
+
+    int update(int64_t key, const std::string &value) override {
+        int ret = checkWrite(key, value);
+        if (ret != OK) {
+            return ret;
+        }
+        TableLock lock(&data_->header.table_mutex);
+        int pos = probe(static_cast<Key>(key), nullptr);
+        if (pos == -1) {
+            return NOT_FOUND;
+        }
+        writeValue(data_->entries[pos], value);
+        return OK;
+    }
+
+    int upsert(int64_t key, const std::string &value) override {
+        int ret = checkWrite(key, value);
+        if (ret != OK) {
+            return ret;
+        }
+        TableLock lock(&data_->header.table_mutex);
+        return upsertLocked(static_cast<Key>(key), value);
+    }
+
+    int remove(int64_t key) override {
+        if (!validKey(key)) {
+            return -1;
+        }
+        TableLock lock(&data_->header.table_mutex);
+        int pos = probe(static_cast<Key>(key), nullptr);
+        if (pos == -1) {
+            return NOT_FOUND;
+        }
+        data_->entries[pos].state = DELETED;
+        data_->header.current_count.fetch_sub(1, std::memory_order_relaxed);
+        data_->header.deleted_count++;
+        return OK;
+    }
+
+    int contains(int64_t key) override { return get(key, nullptr) == OK ? 1 : 0; }
+
+    int count() const override {
+        return data_->header.current_count.load(std::memory_order_relaxed);
+    }
+
+    int clear() override {
+        TableLock lock(&data_->header.table_mutex);
+        for (int i = 0; i < Capacity; ++i) {
+            data_->entries[i].state = EMPTY;
+        }
+        data_->header.current_count.store(0, std::memory_order_relaxed);
+        data_->header.deleted_count = 0;
+        return OK;
+    }
+
+    int batchUpdate(const std::map<int64_t, std::string> &updated) override {
+        TableLock lock(&data_->header.table_mutex);
+        int success_count = 0;
+        for (const auto &pair : updated) {
+            if (checkWrite(pair.first, pair.second) != OK) {
+                continue;
+            }
+            int pos = probe(static_cast<Key>(pair.first), nullptr);
+            if (pos != -1) {
+                writeValue(data_->entries[pos], pair.second);
+                success_count++;
+            }
+        }
+        return success_count;
+    }
+
+    int batchUpsert(const std::map<int64_t, std::string> &upserted) override {
+        TableLock lock(&data_->header.table_mutex);
+        int success_count = 0;
+        for (const auto &pair : upserted) {
+            if (checkWrite(pair.first, pair.second) == OK &&
+                upsertLocked(static_cast<Key>(pair.first), pair.second) == OK) {
+                success_count++;
+            }
+        }
+        return success_count;
+    }
+
+    int batchGet(std::map<int64_t, std::string> &fetched) override {
+        TableLock lock(&data_->header.table_mutex);
+        fetched.clear();
+        for (int i = 0; i < Capacity; ++i) {
+            const Entry &entry = data_->entries[i];
+            if (entry.state == OCCUPIED) {
+                fetched[entry.key] = entry.value;
+            }
+        }
+        return static_cast<int>(fetched.size());
+    }
+
+    void printStats() override {
+        TableLock lock(&data_->header.table_mutex);
+
+        // 统计每个条目从主位置开始的探测长度
+        long total_probes = 0;
+        int max_probes = 0;
+        for (int i = 0; i < Capacity; ++i) {
+            const Entry &entry = data_->entries[i];
+            if (entry.state != OCCUPIED) {
+                continue;
+            }
+            uint32_t pos = hash1(entry.key);
+            uint32_t step = hash2(entry.key);
+            int probes = 1;
+            while (pos != static_cast<uint32_t>(i)) {
+                pos = (pos + step) & MASK;
+                probes++;
+            }
+            total_probes += probes;
+            if (probes > max_probes) {
+                max_probes = probes;
+            }
+        }
+
+        int current = count();
+        std::cout << "=== Specialized Hash Table Statistics ===" << std::endl;
+        std::cout << "Config: " << Capacity << " slots, " << ValueLen << "-byte values, "
+                  << sizeof(Key) << "-byte keys" << std::endl;
+        std::cout << "Entry Size: " << sizeof(Entry) << " bytes" << std::endl;
+        std::cout << "Current Count: " << current << std::endl;
+        std::cout << "Deleted Count: " << data_->header.deleted_count << std::endl;
+        std::cout << "Load Factor: " << static_cast<double>(current) / Capacity << std::endl;
+        std::cout << "Average Probe Length: "
+                  << (current > 0 ? static_cast<double>(total_probes) / current : 0.0) << std::endl;
+        std::cout << "Max Probe Length: " << max_probes << std::endl;
+        std::cout << "Hash Seed: " << data_->header.hash_seed << std::endl;
+    }
+
+private:
+    static bool validKey(int64_t key) {
+        return sizeof(Key) == sizeof(int64_t) || (key >= INT_MIN && key <= INT_MAX);
+    }
+
+    static int checkWrite(int64_t key, const std::string &value) {
+        if (!validKey(key) || value.empty()) {
+            return -1;
+        }
+        return value.length() >= static_cast<size_t>(ValueLen) ? NO_SPACE_ERR : OK;
+    }
+
+    uint32_t hash1(Key key) const {
+        return murmurMix1(foldKey(key), data_->header.hash_seed) & MASK;
+    }
+
+    // 奇数步长与2的幂次容量互质，探测序列覆盖全部槽位
+    uint32_t hash2(Key key) const {
+        return (murmurMix2(foldKey(key), data_->header.hash_seed) & MASK) | 1;
+    }
+
+    // 返回键所在位置，不存在返回-1；free_slot非空时写入第一个可插入的位置
+    int probe(Key key, int *free_slot) const {
+        uint32_t pos = hash1(key);
+        uint32_t step = hash2(key);
+        if (free_slot != nullptr) {
+            *free_slot = -1;
+        }
+        for (int i = 0; i < Capacity; ++i) {
+            const Entry &entry = data_->entries[pos];
+            if (entry.state == EMPTY) {
+                if (free_slot != nullptr && *free_slot == -1) {
+                    *free_slot = static_cast<int>(pos);
+                }
+                return -1;
+            }
+            if (entry.state == OCCUPIED) {
+                if (entry.key == key) {
+                    return static_cast<int>(pos);
+                }
+            } else if (free_slot != nullptr && *free_slot == -1) {
+                *free_slot = static_cast<int>(pos);
+            }
+            pos = (pos + step) & MASK;
+        }
+        return -1;
+    }
+
+    static void writeValue(Entry &entry, const std::string &value) {
+        strncpy(entry.value, value.c_str(), ValueLen - 1);
+        entry.value[ValueLen - 1] = '\0';
+    }
+
+    int upsertLocked(Key key, const std::string &value) {
+        int free_slot = -1;
+        int pos = probe(key, &free_slot);
+        if (pos != -1) {
+            writeValue(data_->entries[pos], value);
+            return OK;
+        }
+        return insertLocked(key, value, free_slot);
+    }
+
+    // free_slot为probe给出的插入位置
+    int insertLocked(Key key, const std::string &value, int free_slot) {
+        SpecializedHeader &header = data_->header;
+        int current = header.current_count.load(std::memory_order_relaxed);
+        if (current >= MAX_COUNT) {
+            return NO_SPACE_ERR;
+        }
+        if (current + header.deleted_count >= MAX_COUNT) {
+            // 删除标记过多会拉长探测链，原地重建后重新定位
+            purgeDeleted();
+            probe(key, &free_slot);
+        }
+        if (free_slot == -1) {
+            return NO_SPACE_ERR;
+        }
+
+        Entry &entry = data_->entries[free_slot];
+        if (entry.state == DELETED) {
+            header.deleted_count--;
+        }
+        entry.key = key;
+        writeValue(entry, value);
+        entry.state = OCCUPIED;
+        header.current_count.fetch_add(1, std::memory_order_relaxed);
+        return OK;
+    }
+
+    void purgeDeleted() {
+        std::vector<Entry> live;
+        live.reserve(count());
+        for (int i = 0; i < Capacity; ++i) {
+            if (data_->entries[i].state == OCCUPIED) {
+                live.push_back(data_->entries[i]);
+            }
+            data_->entries[i].state = EMPTY;
+        }
+        for (const Entry &entry : live) {
+            int free_slot = -1;
+            probe(entry.key, &free_slot);
+            data_->entries[free_slot] = entry;
+        }
+        data_->header.deleted_count = 0;
+    }
+
+private:
+    Data *data_;
+};
+
+struct EngineEntry {
+    EngineConfig config;
+    size_t segment_size;
+    void (*init)(void *segment);
+    SpecializedEngine *(*attach)(void *segment);
+};
+
+template <int Capacity, int ValueLen, class Key> EngineEntry engineEntry() {
+    typedef SpecializedTable<Capacity, ValueLen, Key> Table;
+    EngineEntry entry = {Table::config(), sizeof(typename Table::Data), &Table::init,
+                         &Table::attach};
+    return entry;
+}
+
+// 预实例化的配置表，第一行与默认引擎的编译期常量相同
+const EngineEntry *engineTable(int *count) {
+    static const EngineEntry table[] = {
+        engineEntry<HASH_TABLE_SIZE, MAX_VALUE_LEN, int32_t>(),
+        engineEntry<16384, MAX_VALUE_LEN, int32_t>(),
+        engineEntry<131072, 64, int32_t>(),
+        engineEntry<4096, 1024, int32_t>(),
+        engineEntry<65536, 128, int64_t>(),
+    };
+    *count = static_cast<int>(sizeof(table) / sizeof(table[0]));
+    return table;
+}
+
+bool sameConfig(const EngineConfig &a, const EngineConfig &b) {
+    return a.capacity == b.capacity && a.value_len == b.value_len && a.key_size == b.key_size;
+}
+
+const EngineEntry *findEngine(const EngineConfig &config) {
+    int count = 0;
+    const EngineEntry *table = engineTable(&count);
+    for (int i = 0; i < count; ++i) {
+        if (sameConfig(table[i].config, config)) {
+            return &table[i];
+        }
+    }
+    return nullptr;
+}
+
+std::string describe(const EngineConfig &config) {
+    return std::to_string(config.capacity) + " slots/" + std::to_string(config.value_len) +
+           "-byte values/" + std::to_string(config.key_size) + "-byte keys";
+}
+
+std::string segmentName(const std::string &name) {
+    return "/specialized_status_" + name;
+}
+
+} // namespace
+
+int specializedConfigCount() {
+    int count = 0;
+    engineTable(&count);
+    return count;
+}
+
+EngineConfig specializedConfig(int index) {
+    int count = 0;
+    const EngineEntry *table = engineTable(&count);
+    if (index < 0 || index >= count) {
+        EngineConfig none = {0, 0, 0};
+        return none;
+    }
+    return table[index].config;
+}
+
+SpecializedStatusRscManager &SpecializedStatusRscManager::getInstance(const std::string &name,
+                                                                      const EngineConfig *config) {
+    static std::mutex instances_mutex;
+    static std::map<std::string, std::unique_ptr<SpecializedStatusRscManager>> instances;
+
+    std::lock_guard<std::mutex> guard(instances_mutex);
+    auto it = instances.find(name);
+    if (it != instances.end()) {
+        if (config != nullptr && !sameConfig(*config, it->second->config_)) {
+            throw std::runtime_error("specialized segment " + name + " uses " +
+                                     describe(it->second->config_));
+        }
+        return *it->second;
+    }
+
+    std::unique_ptr<SpecializedStatusRscManager> manager(
+        new SpecializedStatusRscManager(name, config));
+    SpecializedStatusRscManager &result = *manager;
+    instances[name] = std::move(manager);
+    return result;
+}
+
+SpecializedStatusRscManager::SpecializedStatusRscManager(const std::string &name,
+                                                         const EngineConfig *config)
+    : shm_name_(segmentName(name)), shm_fd_(-1), mapping_(nullptr), mapped_size_(0) {
+    if (name.empty() || name.find('/') != std::string::npos || shm_name_.length() > NAME_MAX) {
+        throw std::runtime_error("invalid specialized segment name: " + name);
+    }
+
+    const EngineEntry *entry = nullptr;
+    if (config != nullptr) {
+        entry = findEngine(*config);
+        if (entry == nullptr) {
+            throw std::runtime_error("no specialized engine for " + describe(*config));
+        }
+    }
+
+    // 尝试打开已存在的共享内存，不存在且给出了配置时创建
+    bool is_creator = false;
+    shm_fd_ = shm_open(shm_name_.c_str(), O_RDWR, 0666);
+    if (shm_fd_ == -1 && config != nullptr) {
+        shm_fd_ = shm_open(shm_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+        if (shm_fd_ == -1 && errno == EEXIST) {
+            // 其他进程刚刚创建了，重新尝试打开
+            shm_fd_ = shm_open(shm_name_.c_str(), O_RDWR, 0666);
+        } else if (shm_fd_ != -1) {
+            is_creator = true;
+        }
+    }
+    if (shm_fd_ == -1) {
+        throw std::runtime_error("shm_open failed: " + std::string(strerror(errno)));
+    }
+
+    if (is_creator) {
+        mapped_size_ = entry->segment_size;
+        if (ftruncate(shm_fd_, mapped_size_) == -1) {
+            close(shm_fd_);
+            shm_unlink(shm_name_.c_str());
+            throw std::runtime_error("ftruncate failed: " + std::string(strerror(errno)));
+        }
+    } else {
+        // 等待创建者设置段大小
+        struct stat st;
+        while (true) {
+            if (fstat(shm_fd_, &st) == -1) {
+                close(shm_fd_);
+                throw std::runtime_error("fstat failed: " + std::string(strerror(errno)));
+            }
+            if (static_cast<size_t>(st.st_size) >= sizeof(SpecializedHeader)) {
+                break;
+            }
+            usleep(1000);
+        }
+        mapped_size_ = st.st_size;
+    }
+
+    mapping_ = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        close(shm_fd_);
+        if (is_creator) {
+            shm_unlink(shm_name_.c_str());
+        }
+        throw std::runtime_error("mmap failed: " + std::string(strerror(errno)));
+    }
+
+    SpecializedHeader *header = static_cast<SpecializedHeader *>(mapping_);
+    if (is_creator) {
+        header->magic = SPECIALIZED_MAGIC;
+        header->capacity = static_cast<uint32_t>(config->capacity);
+        header->value_len = static_cast<uint32_t>(config->value_len);
+        header->key_size = static_cast<uint32_t>(config->key_size);
+        std::random_device rd;
+        header->hash_seed = rd();
+        initSharedMutex(&header->table_mutex);
+        header->current_count.store(0, std::memory_order_relaxed);
+        header->deleted_count = 0;
+        entry->init(mapping_);
+
+        // 标记初始化完成
+        std::atomic_thread_fence(std::memory_order_release);
+        header->initialized = true;
+    } else {
+        while (!header->initialized) {
+            usleep(1000); // 等待1ms
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // 按段头选择特化版本，而不是按调用者给出的配置
+        EngineConfig stored = {static_cast<int>(header->capacity),
+                               static_cast<int>(header->value_len),
+                               static_cast<int>(header->key_size)};
+        std::string error;
+        if (header->magic != SPECIALIZED_MAGIC) {
+            error = "not a specialized segment: " + name;
+        } else if (config != nullptr && !sameConfig(*config, stored)) {
+            error = "specialized segment " + name + " uses " + describe(stored);
+        } else if ((entry = findEngine(stored)) == nullptr) {
+            error = "no specialized engine for " + describe(stored);
+        } else if (mapped_size_ < entry->segment_size) {
+            error = "specialized segment " + name + " is truncated";
+        }
+        if (!error.empty()) {
+            munmap(mapping_, mapped_size_);
+            mapping_ = nullptr;
+            close(shm_fd_);
+            throw std::runtime_error(error);
+        }
+    }
+
+    config_ = entry->config;
+    engine_.reset(entry->attach(mapping_));
+}
+
+SpecializedStatusRscManager::~SpecializedStatusRscManager() {
+    engine_.reset();
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mapped_size_);
+    }
+    if (shm_fd_ != -1) {
+        close(shm_fd_);
+    }
+}
+
+int SpecializedStatusRscManager::cleanup(const std::string &name) {
+    if (shm_unlink(segmentName(name).c_str()) == -1) {
+        if (errno != ENOENT) {
+            return -1;
+        }
+    }
+    return OK;
+}
+
+// 实现接口方法
+int SpecializedStatusRscManager::addRsc(int rsc_key, const std::string &rsc_value) {
+    return engine_->add(rsc_key, rsc_value);
+}
+
+std::string SpecializedStatusRscManager::getRsc(int rsc_key) {
+    std::string result;
+    engine_->get(rsc_key, &result);
+    return result;
+}
+
+int SpecializedStatusRscManager::updateRsc(int rsc_key, const std::string &rsc_value) {
+    return engine_->update(rsc_key, rsc_value);
+}
+
+int SpecializedStatusRscManager::upsertRsc(int rsc_key, const std::string &rsc_value) {
+    return engine_->upsert(rsc_key, rsc_value);
+}
+
+int SpecializedStatusRscManager::removeRsc(int rsc_key) {
+    return engine_->remove(rsc_key);
+}
+
+int SpecializedStatusRscManager::isContain(int rsc_key) {
+    return engine_->contains(rsc_key);
+}
+
+int SpecializedStatusRscManager::rscNum() {
+    return engine_->count();
+}
+
+int SpecializedStatusRscManager::clearRsc() {
+    return engine_->clear();
+}
+
+double SpecializedStatusRscManager::getLoadFactor() {
+    return static_cast<double>(engine_->count()) / config_.capacity;
+}
+
+void SpecializedStatusRscManager::printStats() {
+    engine_->printStats();
+}
+
+int SpecializedStatusRscManager::batchUpdateRsc(const std::map<int, std::string> &updated_map) {
+    std::map<int64_t, std::string> updated(updated_map.begin(), updated_map.end());
+    return engine_->batchUpdate(updated);
+}
+
+int SpecializedStatusRscManager::batchUpsertRsc(const std::map<int, std::string> &upserted_map) {
+    std::map<int64_t, std::string> upserted(upserted_map.begin(), upserted_map.end());
+    return engine_->batchUpsert(upserted);
+}
+
+int SpecializedStatusRscManager::batchGetRsc(std::map<int, std::string> &fetched_map) {
+    std::map<int64_t, std::string> fetched;
+    engine_->batchGet(fetched);
+
+    // 8字节键的配置中超出int范围的键无法通过本接口返回
+    fetched_map.clear();
+    for (const auto &pair : fetched) {
+        if (pair.first >= INT_MIN && pair.first <= INT_MAX) {
+            fetched_map.emplace_hint(fetched_map.end(), static_cast<int>(pair.first), pair.second);
+        }
+    }
+    return static_cast<int>(fetched_map.size());
+}
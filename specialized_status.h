@@ -0,0 +1,103 @@
+#pragma once
+
+#include "optimized_status.h"
+#include <map>
+#include <memory>
+#include <string>
+
+// 编译期特化的哈希表引擎：容量、值长度和键类型都是模板参数，探测用的掩码和
+// 条目偏移全部是编译期常量。每个段的段头记录创建时的配置，附加的进程据此绑定到
+// 对应的预实例化版本，从而按部署选择表大小而不在查找路径上引入运行期参数
+const uint32_t SPECIALIZED_MAGIC = 0x53504543; // "SPEC"
+
+struct EngineConfig {
+  int capacity;  // 槽位数，2的幂次
+  int value_len; // 值缓冲区长度，含结尾'\0'
+  int key_size;  // 键的字节数，4或8
+};
+
+// 段头：配置字段在initialized置位前写好，之后不再改变
+struct SpecializedHeader {
+  uint32_t magic;
+  uint32_t capacity;
+  uint32_t value_len;
+  uint32_t key_size;
+  uint32_t hash_seed;
+  volatile bool initialized;
+
+  alignas(CACHE_LINE_SIZE) pthread_mutex_t table_mutex;
+  std::atomic<int> current_count;
+  int deleted_count;
+};
+
+// 预实例化的配置；新增配置只需在specialized_status.cpp的配置表中加一行
+int specializedConfigCount();
+EngineConfig specializedConfig(int index);
+
+// 各特化版本的公共接口，一次虚调用之后的探测循环全部使用编译期常量。
+// 键统一以int64_t传入，4字节键的版本拒绝超出int范围的键（返回-1）
+class SpecializedEngine {
+public:
+  virtual ~SpecializedEngine() = default;
+
+  virtual int add(int64_t key, const std::string &value) = 0;
+  virtual int get(int64_t key, std::string *value) = 0; // 不存在返回NOT_FOUND
+  virtual int update(int64_t key, const std::string &value) = 0;
+  virtual int upsert(int64_t key, const std::string &value) = 0;
+  virtual int remove(int64_t key) = 0;
+  virtual int contains(int64_t key) = 0;
+
+  virtual int count() const = 0;
+  virtual int clear() = 0;
+  virtual int batchUpdate(const std::map<int64_t, std::string> &updated) = 0;
+  virtual int batchUpsert(const std::map<int64_t, std::string> &upserted) = 0;
+  virtual int batchGet(std::map<int64_t, std::string> &fetched) = 0;
+  virtual void printStats() = 0;
+};
+
+class SpecializedStatusRscManager : public ISharedMemoryManager {
+public:
+  // 打开名为name的段，段不存在时按config创建；config为nullptr时只附加已有段。
+  // 配置或段头没有对应的预实例化版本时抛出std::runtime_error
+  static SpecializedStatusRscManager &
+  getInstance(const std::string &name, const EngineConfig *config = nullptr);
+  static int cleanup(const std::string &name);
+
+  ~SpecializedStatusRscManager();
+  SpecializedStatusRscManager(const SpecializedStatusRscManager &) = delete;
+  SpecializedStatusRscManager &
+  operator=(const SpecializedStatusRscManager &) = delete;
+
+  // 实现接口方法
+  int addRsc(int key, const std::string &value) override;
+  std::string getRsc(int key) override;
+  int updateRsc(int key, const std::string &value) override;
+  int upsertRsc(int key, const std::string &value) override;
+  int removeRsc(int key) override;
+  int isContain(int key) override;
+  int rscNum() override;
+  int clearRsc() override;
+  double getLoadFactor() override;
+  void printStats() override;
+
+  // 批量操作
+  int batchUpdateRsc(const std::map<int, std::string> &updated_map) override;
+  int batchGetRsc(std::map<int, std::string> &fetched_map) override;
+  int batchUpsertRsc(const std::map<int, std::string> &upserted_map) override;
+
+  const EngineConfig &config() const { return config_; }
+  // 8字节键的配置通过engine()使用完整的键范围
+  SpecializedEngine &engine() { return *engine_; }
+
+private:
+  SpecializedStatusRscManager(const std::string &name,
+                              const EngineConfig *config);
+
+private:
+  std::string shm_name_;
+  int shm_fd_;
+  void *mapping_;
+  size_t mapped_size_;
+  EngineConfig config_;
+  std::unique_ptr<SpecializedEngine> engine_;
+};
@@ -0,0 +1,74 @@
+#include "table_scan.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <utility>
+
+void ScanArena::clear() {
+    keys.clear();
+    offsets.clear();
+    lengths.clear();
+    values.clear();
+}
+
+void ScanArena::reserve(size_t entries, size_t value_bytes) {
+    keys.reserve(entries);
+    offsets.reserve(entries);
+    lengths.reserve(entries);
+    values.reserve(value_bytes);
+}
+
+void ScanArena::append(int key, const char *value, size_t length) {
+    keys.push_back(key);
+    offsets.push_back(static_cast<uint32_t>(values.size()));
+    lengths.push_back(static_cast<uint16_t>(length));
+    values.insert(values.end(), value, value + length);
+}
+
+void sortArena(ScanArena &arena) {
+    std::vector<uint32_t> order(arena.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    std::sort(order.begin(), order.end(),
+              [&arena](uint32_t a, uint32_t b) { return arena.keys[a] < arena.keys[b]; });
+
+    ScanArena sorted;
+    sorted.reserve(arena.size(), arena.values.size());
+    for (uint32_t i : order) {
+        sorted.append(arena.keys[i], arena.values.data() + arena.offsets[i], arena.lengths[i]);
+    }
+    std::swap(arena, sorted);
+}
+
+void mergeSortedArenas(const std::vector<ScanArena> &parts, ScanArena &out) {
+    size_t entries = 0;
+    size_t value_bytes = 0;
+    for (const ScanArena &part : parts) {
+        entries += part.size();
+        value_bytes += part.values.size();
+    }
+    out.clear();
+    out.reserve(entries, value_bytes);
+
+    // 小顶堆：(键, 段序号)，每段维护一个读取位置
+    typedef std::pair<int, size_t> Head;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+    std::vector<size_t> cursor(parts.size(), 0);
+    for (size_t p = 0; p < parts.size(); ++p) {
+        if (parts[p].size() > 0) {
+            heap.push(Head(parts[p].keys[0], p));
+        }
+    }
+    while (!heap.empty()) {
+        size_t p = heap.top().second;
+        heap.pop();
+        const ScanArena &part = parts[p];
+        size_t i = cursor[p]++;
+        out.append(part.keys[i], part.values.data() + part.offsets[i], part.lengths[i]);
+        if (cursor[p] < part.size()) {
+            heap.push(Head(part.keys[cursor[p]], p));
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 全表扫描的输出区：条目连续存放，第i个条目的值为
+// values中[offsets[i], offsets[i] + lengths[i])，不以'\0'结尾
+struct ScanArena {
+  std::vector<int> keys;
+  std::vector<uint32_t> offsets;
+  std::vector<uint16_t> lengths;
+  std::vector<char> values;
+
+  size_t size() const { return keys.size(); }
+  std::string value(size_t i) const {
+    return std::string(values.data() + offsets[i], lengths[i]);
+  }
+
+  void clear();
+  void reserve(size_t entries, size_t value_bytes);
+  void append(int key, const char *value, size_t length);
+};
+
+// 按键排序单个输出区，可在各扫描线程中并行调用
+void sortArena(ScanArena &arena);
+// 归并若干已排序的输出区
+void mergeSortedArenas(const std::vector<ScanArena> &parts, ScanArena &out);
@@ -0,0 +1,177 @@
+#include "value_history.h"
+#include "batch_hash.h"
+#include "optimized_status.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+const uint32_t RING_EMPTY = 0;
+const uint32_t RING_OCCUPIED = 1;
+
+inline size_t alignUp(size_t size, size_t alignment) {
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+inline size_t ringsOffset() {
+    return alignUp(sizeof(ValueHistoryData), CACHE_LINE_SIZE);
+}
+
+} // namespace
+
+// 环头之后依次是depth条记录；next为下一条要写入的位置，count为已写入的条数
+struct ValueHistory::RingHeader {
+    int key;
+    uint32_t state;
+    uint32_t next;
+    uint32_t count;
+};
+
+struct ValueHistory::RecordHeader {
+    uint64_t timestamp_ns;
+    uint32_t length;
+    uint32_t truncated;
+};
+
+size_t ValueHistory::requiredSize(int depth, int value_len, int capacity) {
+    if (depth <= 0 || depth > HISTORY_MAX_DEPTH || value_len <= 0 || value_len > MAX_VALUE_LEN ||
+        capacity <= 0 || (capacity & (capacity - 1)) != 0) {
+        return 0;
+    }
+    size_t record_stride = alignUp(sizeof(RecordHeader) + value_len, sizeof(uint64_t));
+    size_t ring_stride = sizeof(RingHeader) + depth * record_stride;
+    return ringsOffset() + static_cast<size_t>(capacity) * ring_stride;
+}
+
+void ValueHistory::init(ValueHistoryData *data, int depth, int value_len, int capacity, uint32_t seed) {
+    data->depth = depth;
+    data->value_len = value_len;
+    data->capacity = capacity;
+    data->hash_seed = seed;
+    data->record_stride = alignUp(sizeof(RecordHeader) + value_len, sizeof(uint64_t));
+    data->ring_stride = sizeof(RingHeader) + depth * data->record_stride;
+    data->reserved = 0;
+    ValueHistory(data).clear();
+}
+
+ValueHistory::RingHeader *ValueHistory::ring(uint32_t index) const {
+    char *base = reinterpret_cast<char *>(data_) + ringsOffset();
+    return reinterpret_cast<RingHeader *>(base + index * data_->ring_stride);
+}
+
+ValueHistory::RecordHeader *ValueHistory::record(RingHeader *ring, uint32_t slot) const {
+    char *base = reinterpret_cast<char *>(ring) + sizeof(RingHeader);
+    return reinterpret_cast<RecordHeader *>(base + slot * data_->record_stride);
+}
+
+uint32_t ValueHistory::home(int key) const {
+    return murmurMix1(key, data_->hash_seed) & (data_->capacity - 1);
+}
+
+int ValueHistory::findRing(int key) const {
+    uint32_t mask = data_->capacity - 1;
+    uint32_t pos = home(key);
+    for (uint32_t probes = 0; probes < data_->capacity; ++probes) {
+        RingHeader *current = ring(pos);
+        if (current->state == RING_EMPTY) {
+            return -1;
+        }
+        if (current->key == key) {
+            return static_cast<int>(pos);
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+void ValueHistory::append(int key, const char *value, size_t length, uint64_t timestamp_ns) {
+    int index = findRing(key);
+    RingHeader *target;
+    if (index != -1) {
+        target = ring(index);
+    } else {
+        // 与热表相同的装载上限，保证探测总能遇到空环
+        if (data_->tracked >= data_->capacity / 4 * 3) {
+            data_->dropped++;
+            return;
+        }
+        uint32_t pos = home(key);
+        while (ring(pos)->state != RING_EMPTY) {
+            pos = (pos + 1) & (data_->capacity - 1);
+        }
+        target = ring(pos);
+        target->key = key;
+        target->next = 0;
+        target->count = 0;
+        target->state = RING_OCCUPIED;
+        data_->tracked++;
+    }
+
+    RecordHeader *slot = record(target, target->next);
+    bool truncated = length > data_->value_len;
+    slot->timestamp_ns = timestamp_ns;
+    slot->length = static_cast<uint32_t>(truncated ? data_->value_len : length);
+    slot->truncated = truncated ? 1 : 0;
+    memcpy(reinterpret_cast<char *>(slot) + sizeof(RecordHeader), value, slot->length);
+    if (truncated) {
+        data_->truncated++;
+    }
+    target->next = (target->next + 1) % data_->depth;
+    if (target->count < data_->depth) {
+        target->count++;
+    }
+}
+
+int ValueHistory::get(int key, std::vector<HistoryEntry> &entries, int limit) const {
+    entries.clear();
+    int index = findRing(key);
+    if (index == -1) {
+        return NOT_FOUND;
+    }
+    RingHeader *source = ring(index);
+    uint32_t count = source->count;
+    if (limit > 0 && static_cast<uint32_t>(limit) < count) {
+        count = limit;
+    }
+    entries.reserve(count);
+    uint32_t slot = source->next;
+    for (uint32_t i = 0; i < count; ++i) {
+        slot = (slot + data_->depth - 1) % data_->depth;
+        const RecordHeader *current = record(source, slot);
+        HistoryEntry entry;
+        entry.timestamp_ns = current->timestamp_ns;
+        entry.value.assign(reinterpret_cast<const char *>(current) + sizeof(RecordHeader), current->length);
+        entry.truncated = current->truncated != 0;
+        entries.push_back(std::move(entry));
+    }
+    return OK;
+}
+
+void ValueHistory::drop(int key) {
+    int index = findRing(key);
+    if (index == -1) {
+        return;
+    }
+    // 后移删除：把探测链上可以前移的环逐个搬入空位，查找无需墓碑
+    uint32_t mask = data_->capacity - 1;
+    uint32_t hole = static_cast<uint32_t>(index);
+    for (uint32_t pos = (hole + 1) & mask; ring(pos)->state != RING_EMPTY; pos = (pos + 1) & mask) {
+        uint32_t displacement = (pos - home(ring(pos)->key)) & mask;
+        if (displacement >= ((pos - hole) & mask)) {
+            memcpy(ring(hole), ring(pos), data_->ring_stride);
+            hole = pos;
+        }
+    }
+    ring(hole)->state = RING_EMPTY;
+    data_->tracked--;
+}
+
+void ValueHistory::clear() {
+    for (uint32_t i = 0; i < data_->capacity; ++i) {
+        ring(i)->state = RING_EMPTY;
+    }
+    data_->tracked = 0;
+    data_->dropped = 0;
+    data_->truncated = 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 按键的有界取值历史：每个键一个定长环，写操作成功后追加(时间戳, 值)，
+// 满后覆盖最旧的记录。整个存储从段内通用内存区分配，所有进程共享
+const int HISTORY_DEFAULT_DEPTH = 8;
+const int HISTORY_MAX_DEPTH = 64;
+const int HISTORY_DEFAULT_VALUE_LEN = 64; // 每条记录保存的值字节数上限，更长的值被截断
+
+struct ValueHistoryData {
+  uint32_t depth;
+  uint32_t value_len;
+  uint32_t capacity; // 可跟踪的键数，2的幂次
+  uint32_t hash_seed; // 创建后不变，与表的哈希种子无关
+  uint64_t record_stride;
+  uint64_t ring_stride;
+  uint32_t tracked;   // 以下字段受table_mutex保护
+  uint32_t reserved;
+  uint64_t dropped;   // 因键数超出capacity而未记录的写入
+  uint64_t truncated; // 值超过value_len而被截断的记录
+};
+
+// 读取结果
+struct HistoryEntry {
+  uint64_t timestamp_ns; // 写入时刻，system_clock
+  std::string value;
+  bool truncated;
+};
+
+// 共享内存中ValueHistoryData的无状态访问器，所有操作要求调用者持有table_mutex
+// 环按线性探测存放，删除时后移填补空位，不留墓碑
+class ValueHistory {
+public:
+  explicit ValueHistory(ValueHistoryData *data) : data_(data) {}
+
+  // 存储（含所有环）所需的字节数，参数超出范围时返回0
+  static size_t requiredSize(int depth, int value_len, int capacity);
+  static void init(ValueHistoryData *data, int depth, int value_len,
+                   int capacity, uint32_t seed);
+
+  void append(int key, const char *value, size_t length,
+              uint64_t timestamp_ns);
+  // 按从新到旧的顺序返回最多limit条（<=0表示全部），键无历史返回NOT_FOUND
+  int get(int key, std::vector<HistoryEntry> &entries, int limit = 0) const;
+  void drop(int key);
+  void clear();
+
+  int depth() const { return static_cast<int>(data_->depth); }
+  int valueLen() const { return static_cast<int>(data_->value_len); }
+  int trackedKeys() const { return static_cast<int>(data_->tracked); }
+  uint64_t dropped() const { return data_->dropped; }
+  uint64_t truncated() const { return data_->truncated; }
+
+private:
+  struct RingHeader;
+  struct RecordHeader;
+
+  RingHeader *ring(uint32_t index) const;
+  RecordHeader *record(RingHeader *ring, uint32_t slot) const;
+  uint32_t home(int key) const;
+  // 键所在的环，不存在时返回-1
+  int findRing(int key) const;
+
+private:
+  ValueHistoryData *data_;
+};
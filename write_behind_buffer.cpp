@@ -0,0 +1,130 @@
+#include "write_behind_buffer.h"
+#include "optimized_status.h"
+
+WriteBehindBuffer::WriteBehindBuffer(ISharedMemoryManager *manager,
+                                     const WriteBehindOptions &options)
+    : manager_(manager), options_(options), stopping_(false), flush_count_(0),
+      coalesced_count_(0), failed_count_(0), last_flush_error_(OK) {
+    if (options_.flush_interval_ms > 0) {
+        flusher_ = std::thread(&WriteBehindBuffer::flusherLoop, this);
+    }
+}
+
+WriteBehindBuffer::~WriteBehindBuffer() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+    flush();
+}
+
+int WriteBehindBuffer::upsertRsc(int key, const std::string &value) {
+    if (value.empty()) return -1;
+
+    if (value.length() >= MAX_VALUE_LEN) {
+        return NO_SPACE_ERR;
+    }
+
+    bool need_flush = false;
+    bool first_pending = false;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        Clock::time_point now = Clock::now();
+        if (pending_.empty()) {
+            oldest_pending_ = now;
+            first_pending = true;
+        }
+
+        auto it = pending_.find(key);
+        if (it != pending_.end()) {
+            it->second = value;
+            coalesced_count_++;
+        } else {
+            pending_[key] = value;
+        }
+
+        need_flush = static_cast<int>(pending_.size()) >= options_.max_pending ||
+                     now - oldest_pending_ >= std::chrono::milliseconds(options_.max_staleness_ms);
+    }
+
+    if (need_flush) {
+        flush();
+    } else if (first_pending) {
+        cv_.notify_one();  // 后台线程按新的最早更新重新计算唤醒时刻
+    }
+    return OK;
+}
+
+std::string WriteBehindBuffer::getRsc(int key) {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = pending_.find(key);
+        if (it != pending_.end()) {
+            return it->second;
+        }
+    }
+    // 可能正处于刷新过程中，等待其完成后再读共享内存表
+    std::lock_guard<std::mutex> flush_guard(flush_mutex_);
+    return manager_->getRsc(key);
+}
+
+int WriteBehindBuffer::flush() {
+    std::lock_guard<std::mutex> flush_guard(flush_mutex_);
+
+    std::map<int, std::string> batch;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        batch.swap(pending_);
+    }
+    if (batch.empty()) {
+        return 0;
+    }
+
+    flush_count_++;
+    int written = manager_->batchUpsertRsc(batch);
+    // 值长度已在缓冲时检查，未写入的条目是表空间不足
+    if (written < static_cast<int>(batch.size())) {
+        failed_count_ += static_cast<long long>(batch.size()) - (written > 0 ? written : 0);
+        last_flush_error_ = NO_SPACE_ERR;
+    }
+    return written;
+}
+
+int WriteBehindBuffer::pendingCount() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return static_cast<int>(pending_.size());
+}
+
+void WriteBehindBuffer::flusherLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const std::chrono::milliseconds interval(options_.flush_interval_ms);
+    const std::chrono::milliseconds staleness(options_.max_staleness_ms);
+    Clock::time_point next_tick = Clock::now() + interval;
+    while (!stopping_) {
+        // 按刷新周期唤醒；最早的未刷新更新先达到max_staleness_ms时提前唤醒
+        Clock::time_point wake = next_tick;
+        if (!pending_.empty() && oldest_pending_ + staleness < wake) {
+            wake = oldest_pending_ + staleness;
+        }
+        cv_.wait_until(lock, wake);
+        if (stopping_) {
+            break;
+        }
+        Clock::time_point now = Clock::now();
+        bool tick = now >= next_tick;
+        if (tick) {
+            next_tick = now + interval;
+        }
+        // 被新的首个更新唤醒时只重新计算唤醒时刻
+        if (pending_.empty() || (!tick && now < oldest_pending_ + staleness)) {
+            continue;
+        }
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "shared_memory_inteface.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 写合并缓冲的配置
+struct WriteBehindOptions {
+  WriteBehindOptions()
+      : flush_interval_ms(10), max_pending(256), max_staleness_ms(50) {}
+
+  int flush_interval_ms; // 后台线程刷新周期，<=0时不启动后台线程
+  int max_pending;       // 待刷新的不同键数达到该值时立即刷新
+  // 最早的未刷新更新达到该时长时由后台线程刷新；不启动后台线程时
+  // 由超时后的下一次写入同步刷新，此时不保证上限
+  int max_staleness_ms;
+};
+
+// 进程内写合并缓冲：同一个键的多次更新只保留最新值，
+// 刷新时通过一次batchUpsertRsc（一次加锁）写入共享内存表。
+// upsertRsc在缓冲后即返回OK，刷新时写入失败（如表满）的条目被丢弃，
+// 由failedCount()/lastFlushError()报告
+class WriteBehindBuffer {
+public:
+  explicit WriteBehindBuffer(ISharedMemoryManager *manager,
+                             const WriteBehindOptions &options =
+                                 WriteBehindOptions());
+  // 停止后台线程并刷新剩余的更新
+  ~WriteBehindBuffer();
+
+  WriteBehindBuffer(const WriteBehindBuffer &) = delete;
+  WriteBehindBuffer &operator=(const WriteBehindBuffer &) = delete;
+
+  // 与upsertRsc语义相同，但只写入进程内缓冲；空值返回-1，
+  // 值过长同步返回NO_SPACE_ERR，不进入缓冲
+  int upsertRsc(int key, const std::string &value);
+  // 优先返回本进程尚未刷新的值，保证读到自己的写入
+  std::string getRsc(int key);
+
+  // 立即刷新，返回写入成功的条数
+  int flush();
+
+  int pendingCount();
+  long long flushCount() const { return flush_count_; }
+  long long coalescedCount() const { return coalesced_count_; }
+  // 刷新时未能写入共享内存表的累计条数
+  long long failedCount() const { return failed_count_; }
+  // 最近一次有条目写入失败的刷新的错误码，从未失败时为OK
+  int lastFlushError() const { return last_flush_error_; }
+
+private:
+  void flusherLoop();
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  ISharedMemoryManager *manager_;
+  WriteBehindOptions options_;
+
+  std::mutex mutex_; // 保护pending_及以下状态
+  std::condition_variable cv_;
+  std::map<int, std::string> pending_;
+  Clock::time_point oldest_pending_;
+  bool stopping_;
+
+  std::mutex flush_mutex_; // 串行化刷新，保证批次按顺序写入
+  std::atomic<long long> flush_count_;
+  std::atomic<long long> coalesced_count_; // 被后续更新覆盖而无需写入的次数
+  std::atomic<long long> failed_count_;
+  std::atomic<int> last_flush_error_;
+
+  std::thread flusher_;
+};